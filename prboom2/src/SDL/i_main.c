@@ -75,6 +75,7 @@
 #include "dsda/args.h"
 #include "dsda/analysis.h"
 #include "dsda/args.h"
+#include "dsda/batch.h"
 #include "dsda/endoom.h"
 #include "dsda/settings.h"
 #include "dsda/signal_context.h"
@@ -273,6 +274,9 @@ int main(int argc, char **argv)
   if (dsda_Flag(dsda_arg_quiet))
     I_DisableAllLogging();
 
+  if (dsda_Arg(dsda_arg_batch)->found)
+    return dsda_RunBatch(argv[0]);
+
   // Print the version and exit
   if (dsda_Flag(dsda_arg_v))
   {
@@ -314,6 +318,7 @@ int main(int argc, char **argv)
 
   I_AtExit(I_EssentialQuit, true, "I_EssentialQuit", exit_priority_first);
   I_AtExit(I_Quit, false, "I_Quit", exit_priority_last);
+  dsda_InitBatchJob();
 #ifndef PRBOOM_DEBUG
   if (!dsda_Flag(dsda_arg_sigsegv))
   {
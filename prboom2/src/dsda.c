@@ -38,6 +38,7 @@
 #include "dsda/mouse.h"
 #include "dsda/settings.h"
 #include "dsda/split_tracker.h"
+#include "dsda/state_hash.h"
 #include "dsda/tracker.h"
 #include "dsda/wad_stats.h"
 #include "dsda.h"
@@ -178,6 +179,14 @@ void dsda_ReadCommandLine(void) {
   if (arg->found)
     dsda_InitGhostImport(arg->value.v_string_array, arg->count);
 
+  arg = dsda_Arg(dsda_arg_export_state_hash);
+  if (arg->found)
+    dsda_InitStateHashExport(arg->value.v_string);
+
+  arg = dsda_Arg(dsda_arg_verify_state_hash);
+  if (arg->found)
+    dsda_InitStateHashImport(arg->value.v_string);
+
   if (dsda_Flag(dsda_arg_tas) || dsda_Flag(dsda_arg_build)) dsda_SetTas();
 
   dsda_InitKeyFrame();
@@ -385,6 +394,7 @@ int dsda_MaxKillRequirement() {
 
 void dsda_WatchPTickCompleted(void) {
   dsda_FlipLineActivationTracker();
+  dsda_UpdateStateHash();
 }
 
 void dsda_WatchCommand(void) {
@@ -103,6 +103,11 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "restores state and demo buffer from a key frame file",
     arg_string,
   },
+  [dsda_arg_seek_index] = {
+    "-seek_index", NULL, NULL,
+    "saves a key frame every given number of seconds of demo playback for fast seeking",
+    arg_int, 1, 3600,
+  },
   [dsda_arg_warp] = {
     "-warp", NULL, NULL,
     "warp to the given episode and / or map",
@@ -228,6 +233,11 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "quits the game when brute force ends",
     arg_null,
   },
+  [dsda_arg_brute_force_workers] = {
+    "-brute_force_workers", NULL, NULL,
+    "splits brute force searches across the given number of processes",
+    arg_int, 1, 256,
+  },
   [dsda_arg_first_input] = {
     "-first_input", NULL, NULL,
     "builds the first frame F S T",
@@ -323,6 +333,21 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "writes level stats to levelstat.txt",
     arg_null,
   },
+  [dsda_arg_batch] = {
+    "-batch", NULL, NULL,
+    "plays every demo in the given manifest, writing results to batch.txt",
+    arg_string,
+  },
+  [dsda_arg_batch_jobs] = {
+    "-batch_jobs", NULL, NULL,
+    "sets the number of demos played at once by -batch",
+    arg_int, 1, 256,
+  },
+  [dsda_arg_batch_result] = {
+    "-batch_result", NULL, NULL,
+    "writes the result of a single -batch job to the given file",
+    arg_string,
+  },
   [dsda_arg_export_text_file] = {
     "-export_text_file", NULL, NULL,
     "export a dsda-format text file template",
@@ -338,6 +363,16 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "imports at least one ghost file",
     arg_string_array, AT_LEAST_ONE_STRING,
   },
+  [dsda_arg_export_state_hash] = {
+    "-export_state_hash", NULL, NULL,
+    "exports a hash of the game state for every tic",
+    arg_string,
+  },
+  [dsda_arg_verify_state_hash] = {
+    "-verify_state_hash", NULL, NULL,
+    "stops at the first tic that differs from the given state hash file",
+    arg_string,
+  },
   [dsda_arg_consoleplayer] = {
     "-consoleplayer", NULL, NULL,
     "sets the console player (for coop playback)",
@@ -553,6 +588,51 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "rebuild the blockmap (ignore BLOCKMAP lump)",
     arg_null,
   },
+  [dsda_arg_sight_cache] = {
+    "-sight_cache", NULL, NULL,
+    "reuse sight checks between the same positions within a tic",
+    arg_null,
+  },
+  [dsda_arg_thing_index] = {
+    "-thing_index", NULL, NULL,
+    "index things in crowded blockmap cells by finer position",
+    arg_null,
+  },
+  [dsda_arg_no_level_pool] = {
+    "-no_level_pool", NULL, NULL,
+    "allocate thinkers from the zone instead of the size-class pool",
+    arg_null,
+  },
+  [dsda_arg_bench_intercepts] = {
+    "-bench_intercepts", NULL, NULL,
+    "compare intercept ordering methods over this session's traces on exit",
+    arg_null,
+  },
+  [dsda_arg_timelevelload] = {
+    "-timelevelload", NULL, NULL,
+    "report the time spent in each level setup stage",
+    arg_null,
+  },
+  [dsda_arg_threads] = {
+    "-threads", NULL, NULL,
+    "sets the number of threads used for parallel work (default: cpu count)",
+    arg_int, 1, 16,
+  },
+  [dsda_arg_render_threads] = {
+    "-render_threads", NULL, NULL,
+    "splits the software renderer's walls and planes into this many screen slices",
+    arg_int, 1, 16,
+  },
+  [dsda_arg_frame_checksum] = {
+    "-frame_checksum", NULL, NULL,
+    "report a hash of every software frame on exit",
+    arg_null,
+  },
+  [dsda_arg_test_span_drawers] = {
+    "-test_span_drawers", NULL, NULL,
+    "check the vector span drawers against the scalar one at startup",
+    arg_null,
+  },
   [dsda_arg_force_monster_avoid_hazards] = {
     "-force_monster_avoid_hazards", NULL, NULL,
     "sets a special flag to compensate for sync errors in certain demos",
@@ -31,6 +31,7 @@ typedef enum {
   dsda_arg_record,
   dsda_arg_recordfromto,
   dsda_arg_from_key_frame,
+  dsda_arg_seek_index,
   dsda_arg_warp,
   dsda_arg_skill,
   dsda_arg_episode,
@@ -56,6 +57,7 @@ typedef enum {
   dsda_arg_tas,
   dsda_arg_build,
   dsda_arg_quit_after_brute_force,
+  dsda_arg_brute_force_workers,
   dsda_arg_first_input,
   dsda_arg_command,
   dsda_arg_skipsec,
@@ -75,9 +77,14 @@ typedef enum {
   dsda_arg_update,
   dsda_arg_analysis,
   dsda_arg_levelstat,
+  dsda_arg_batch,
+  dsda_arg_batch_jobs,
+  dsda_arg_batch_result,
   dsda_arg_export_text_file,
   dsda_arg_export_ghost,
   dsda_arg_import_ghost,
+  dsda_arg_export_state_hash,
+  dsda_arg_verify_state_hash,
   dsda_arg_consoleplayer,
   dsda_arg_spechit,
   dsda_arg_setmem,
@@ -121,6 +128,15 @@ typedef enum {
   dsda_arg_emulate,
   dsda_arg_doom95,
   dsda_arg_blockmap,
+  dsda_arg_sight_cache,
+  dsda_arg_thing_index,
+  dsda_arg_no_level_pool,
+  dsda_arg_bench_intercepts,
+  dsda_arg_timelevelload,
+  dsda_arg_threads,
+  dsda_arg_render_threads,
+  dsda_arg_frame_checksum,
+  dsda_arg_test_span_drawers,
   dsda_arg_force_monster_avoid_hazards,
   dsda_arg_force_remove_slime_trails,
   dsda_arg_force_no_dropoff,
@@ -0,0 +1,395 @@
+//
+// Copyright(C) 2026 by the dsda-doom contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Batch
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "doomstat.h"
+#include "e6y.h"
+#include "i_system.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "z_zone.h"
+
+#include "dsda/args.h"
+#include "dsda/state_hash.h"
+
+#include "batch.h"
+
+#define BATCH_REPORT "batch.txt"
+#define BATCH_DELIMITERS " \t\r"
+
+static int batch_exit_tic = -1;
+
+dboolean dsda_BatchJob(void) {
+  return dsda_Arg(dsda_arg_batch_result)->found;
+}
+
+void dsda_RecordBatchLevelExit(void) {
+  batch_exit_tic = gametic;
+}
+
+static void dsda_WriteBatchResult(void) {
+  FILE* file;
+
+  file = M_OpenFile(dsda_Arg(dsda_arg_batch_result)->value.v_string, "wb");
+  if (!file)
+    return;
+
+  fprintf(file, "final_tic %d\n", gametic);
+  fprintf(file, "exit_tic %d\n", batch_exit_tic);
+  fprintf(file, "desync_tic %d\n", dsda_StateHashMismatchTic());
+  fprintf(file, "levelstat\n");
+  e6y_PrintStats(file);
+
+  fclose(file);
+}
+
+void dsda_InitBatchJob(void) {
+  void M_ForgetCurrentConfig(void);
+  void M_ForgetWadStats(void);
+
+  if (!dsda_BatchJob())
+    return;
+
+  // Jobs run side by side, so they must not touch shared files
+  M_ForgetCurrentConfig();
+  M_ForgetWadStats();
+
+  I_AtExit(dsda_WriteBatchResult, true, "dsda_WriteBatchResult", exit_priority_first);
+}
+
+#ifndef _WIN32
+
+typedef struct {
+  const char* lmp;
+  const char* iwad;
+  const char* expected;
+  const char* state_hash;
+  const char** args;
+  int arg_count;
+  char* result_path;
+  pid_t pid;
+  int exit_code;
+  unsigned long long start_time;
+  unsigned long long time;
+  char* result;
+  int final_tic;
+  int exit_tic;
+  int desync_tic;
+  char total[16];
+  const char* status;
+} batch_job_t;
+
+static unsigned long long dsda_BatchTimeMS(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (unsigned long long) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static batch_job_t* dsda_ReadBatchManifest(const char* path, int* count) {
+  batch_job_t* jobs = NULL;
+  int size = 0;
+  int line_number = 0;
+  char* buffer;
+  char* line;
+  char* next;
+
+  if (M_ReadFileToString(path, &buffer) < 0)
+    I_Error("dsda_RunBatch: unable to read %s", path);
+
+  *count = 0;
+
+  for (line = buffer; line; line = next) {
+    batch_job_t* job;
+    char* token;
+    char* save;
+
+    ++line_number;
+
+    next = strchr(line, '\n');
+    if (next)
+      *next++ = '\0';
+
+    token = strchr(line, '#');
+    if (token)
+      *token = '\0';
+
+    token = strtok_r(line, BATCH_DELIMITERS, &save);
+    if (!token)
+      continue;
+
+    if (*count == size) {
+      size = size ? size * 2 : 64;
+      jobs = Z_Realloc(jobs, size * sizeof(*jobs));
+    }
+
+    job = &jobs[(*count)++];
+    memset(job, 0, sizeof(*job));
+
+    job->lmp = token;
+    job->iwad = strtok_r(NULL, BATCH_DELIMITERS, &save);
+    job->expected = job->iwad ? strtok_r(NULL, BATCH_DELIMITERS, &save) : NULL;
+
+    if (!job->expected)
+      I_Error("dsda_RunBatch: line %d of %s needs a demo, an iwad, and an expected result",
+              line_number, path);
+
+    while ((token = strtok_r(NULL, BATCH_DELIMITERS, &save))) {
+      // A state hash file is verified tic by tic, which finds the desync tic
+      if (!job->state_hash && strlen(token) > 4 && !strcasecmp(token + strlen(token) - 4, ".sth")) {
+        job->state_hash = token;
+        continue;
+      }
+
+      job->args = Z_Realloc(job->args, (job->arg_count + 1) * sizeof(*job->args));
+      job->args[job->arg_count++] = token;
+    }
+  }
+
+  return jobs;
+}
+
+static void dsda_StartBatchJob(batch_job_t* job, const char* exe) {
+  const char** argv;
+  const char* tmp;
+  int argc;
+  int fd;
+  int i;
+
+  tmp = M_getenv("TMPDIR");
+  if (!tmp)
+    tmp = "/tmp";
+
+  job->result_path = Z_Malloc(strlen(tmp) + 32);
+  sprintf(job->result_path, "%s/dsda-batch-XXXXXX", tmp);
+
+  fd = mkstemp(job->result_path);
+  if (fd < 0)
+    I_Error("dsda_RunBatch: unable to create %s", job->result_path);
+  close(fd);
+
+  argv = Z_Malloc((job->arg_count + 16) * sizeof(*argv));
+
+  argc = 0;
+  argv[argc++] = exe;
+  argv[argc++] = "-iwad";
+  argv[argc++] = job->iwad;
+  argv[argc++] = "-fastdemo";
+  argv[argc++] = job->lmp;
+  argv[argc++] = "-nosound";
+  argv[argc++] = "-nomusic";
+  argv[argc++] = "-nodraw";
+  argv[argc++] = "-no_message_box";
+  argv[argc++] = "-batch_result";
+  argv[argc++] = job->result_path;
+  if (job->state_hash) {
+    argv[argc++] = "-verify_state_hash";
+    argv[argc++] = job->state_hash;
+  }
+  for (i = 0; i < job->arg_count; ++i)
+    argv[argc++] = job->args[i];
+  argv[argc] = NULL;
+
+  job->start_time = dsda_BatchTimeMS();
+  job->pid = fork();
+
+  if (job->pid < 0)
+    I_Error("dsda_RunBatch: unable to start a job (%s)", strerror(errno));
+
+  if (!job->pid) {
+    fd = open("/dev/null", O_WRONLY);
+    if (fd >= 0) {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+    }
+
+    execvp(exe, (char* const*) argv);
+    _exit(127);
+  }
+
+  Z_Free(argv);
+}
+
+static void dsda_FinishBatchJob(batch_job_t* job, int wait_status) {
+  char* levelstat;
+
+  job->time = dsda_BatchTimeMS() - job->start_time;
+  job->exit_code = WIFEXITED(wait_status) ? WEXITSTATUS(wait_status) : -1;
+  job->final_tic = -1;
+  job->exit_tic = -1;
+  job->desync_tic = -1;
+  strcpy(job->total, "00:00");
+
+  if (M_ReadFileToString(job->result_path, &job->result) > 0) {
+    sscanf(job->result, "final_tic %d exit_tic %d desync_tic %d",
+           &job->final_tic, &job->exit_tic, &job->desync_tic);
+
+    levelstat = strstr(job->result, "levelstat\n");
+    if (levelstat) {
+      char* line;
+
+      // The last level holds the total time, as in "MAP01 - 0:01.23 (0:01)  K: ..."
+      for (line = levelstat + strlen("levelstat\n"); *line; line = strchr(line, '\n') + 1) {
+        sscanf(line, "%*s - %*s (%15[^)])", job->total);
+
+        if (!strchr(line, '\n'))
+          break;
+      }
+    }
+  }
+
+  M_remove(job->result_path);
+
+  // A state hash mismatch ends the job with an error, after the result is written
+  if (job->desync_tic >= 0)
+    job->status = "desync";
+  else if (job->exit_code || job->final_tic < 0)
+    job->status = "error";
+  else if (strcmp(job->expected, "-") && strcmp(job->expected, job->total))
+    job->status = "desync";
+  else
+    job->status = "ok";
+}
+
+static void dsda_WriteBatchJob(FILE* file, batch_job_t* job) {
+  char* levelstat;
+
+  fprintf(file, "demo %s\n", job->lmp);
+  fprintf(file, "status %s\n", job->status);
+  fprintf(file, "exit_code %d\n", job->exit_code);
+  fprintf(file, "final_tic %d\n", job->final_tic);
+  fprintf(file, "exit_tic %d\n", job->exit_tic);
+  fprintf(file, "desync_tic %d\n", job->desync_tic);
+  fprintf(file, "total %s\n", job->total);
+  fprintf(file, "expected %s\n", job->expected);
+  fprintf(file, "time_ms %llu\n", job->time);
+  fprintf(file, "levelstat\n");
+
+  levelstat = job->result ? strstr(job->result, "levelstat\n") : NULL;
+  if (levelstat)
+    fputs(levelstat + strlen("levelstat\n"), file);
+
+  fprintf(file, "end\n\n");
+  fflush(file);
+
+  if (job->result) {
+    Z_Free(job->result);
+    job->result = NULL;
+  }
+}
+
+int dsda_RunBatch(const char* exe) {
+  batch_job_t* jobs;
+  FILE* report;
+  int count;
+  int job_limit;
+  int started, running, finished, written;
+  int failures;
+  unsigned long long start_time;
+
+  jobs = dsda_ReadBatchManifest(dsda_Arg(dsda_arg_batch)->value.v_string, &count);
+
+  job_limit = dsda_Arg(dsda_arg_batch_jobs)->found ?
+              dsda_SimpleIntArg(dsda_arg_batch_jobs) :
+              (int) sysconf(_SC_NPROCESSORS_ONLN);
+  if (job_limit < 1)
+    job_limit = 1;
+
+  report = M_OpenFile(BATCH_REPORT, "w");
+  if (!report)
+    I_Error("dsda_RunBatch: unable to open %s for writing", BATCH_REPORT);
+
+  lprintf(LO_INFO, "Batch: playing %d demos with %d jobs\n", count, job_limit);
+
+  start_time = dsda_BatchTimeMS();
+  started = running = finished = written = failures = 0;
+
+  while (finished < count) {
+    batch_job_t* job;
+    int wait_status;
+    pid_t pid;
+    int i;
+
+    while (running < job_limit && started < count) {
+      dsda_StartBatchJob(&jobs[started++], exe);
+      ++running;
+    }
+
+    pid = waitpid(-1, &wait_status, 0);
+
+    if (pid < 0) {
+      if (errno == EINTR)
+        continue;
+
+      I_Error("dsda_RunBatch: lost track of running jobs (%s)", strerror(errno));
+    }
+
+    job = NULL;
+    for (i = 0; i < started; ++i)
+      if (jobs[i].pid == pid && !jobs[i].status) {
+        job = &jobs[i];
+        break;
+      }
+
+    if (!job)
+      continue;
+
+    dsda_FinishBatchJob(job, wait_status);
+    --running;
+    ++finished;
+
+    if (strcmp(job->status, "ok"))
+      ++failures;
+
+    lprintf(LO_INFO, "  %d / %d: %s %s (%.2f seconds)\n",
+            finished, count, job->lmp, job->status, (float) job->time / 1000);
+
+    // Keep the report in manifest order
+    while (written < count && jobs[written].status)
+      dsda_WriteBatchJob(report, &jobs[written++]);
+  }
+
+  fclose(report);
+
+  lprintf(LO_INFO, "Batch complete: %d / %d demos ok in %.2f seconds, results in %s\n",
+          count - failures, count, (float) (dsda_BatchTimeMS() - start_time) / 1000, BATCH_REPORT);
+
+  return failures ? 1 : 0;
+}
+
+#else
+
+int dsda_RunBatch(const char* exe) {
+  lprintf(LO_ERROR, "dsda_RunBatch: batch mode is not supported on windows\n");
+
+  return 1;
+}
+
+#endif
@@ -0,0 +1,28 @@
+//
+// Copyright(C) 2026 by the dsda-doom contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Batch
+//
+
+#ifndef __DSDA_BATCH__
+#define __DSDA_BATCH__
+
+#include "doomtype.h"
+
+int dsda_RunBatch(const char* exe);
+dboolean dsda_BatchJob(void);
+void dsda_InitBatchJob(void);
+void dsda_RecordBatchLevelExit(void);
+
+#endif
@@ -0,0 +1,520 @@
+//
+// Copyright(C) 2026 by the dsda-doom contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Blockmap
+//
+//	Builds the internal blockmap for maps without a usable BLOCKMAP lump.
+//	Lines are binned into cells on worker threads, then the lists are laid
+//	out exactly as the original single pass builder did: a leading 0, the
+//	lines in descending order, and a trailing -1. Large results are cached
+//	in the data directory, keyed by the map geometry.
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "i_system.h"
+#include "lprintf.h"
+#include "md5.h"
+#include "m_file.h"
+#include "r_state.h"
+#include "z_zone.h"
+
+#include "dsda/data_organizer.h"
+#include "dsda/thread_pool.h"
+#include "dsda/utility.h"
+
+#include "blockmap.h"
+
+#define DSDA_BLOCKMAP_VERSION 1
+
+// Smaller maps rebuild faster than the cache can be checked
+#define BLOCKMAP_CACHE_LINES 4096
+
+#define blkshift 7               /* places to shift rel position for cell num */
+#define blkmask ((1<<blkshift)-1)/* mask for rel position within cell */
+#define blkmargin 0              /* size guardband around map used */
+
+typedef struct {
+  int cell;
+  int line;
+} block_entry_t;
+
+// Lines are split into one contiguous range per chunk, so that reading
+// the chunks back to front visits each cell's lines in descending order
+typedef struct {
+  int start;
+  int end;
+  int* done;
+  block_entry_t* entries;
+  int count;
+  int size;
+  dboolean failed;
+} block_chunk_t;
+
+typedef struct {
+  int xorg, yorg;
+  int ncols, nrows;
+  int chunk_count;
+  block_chunk_t* chunks;
+} block_build_t;
+
+static void dsda_AddBlockLine(block_chunk_t* chunk, int cell, int line) {
+  if (chunk->done[cell] == line + 1)
+    return;
+
+  chunk->done[cell] = line + 1;
+
+  if (chunk->count == chunk->size) {
+    block_entry_t* entries;
+
+    chunk->size = chunk->size ? 2 * chunk->size : 1024;
+    entries = realloc(chunk->entries, chunk->size * sizeof(*entries));
+
+    if (!entries) {
+      chunk->failed = true;
+      return;
+    }
+
+    chunk->entries = entries;
+  }
+
+  chunk->entries[chunk->count].cell = cell;
+  chunk->entries[chunk->count].line = line;
+  ++chunk->count;
+}
+
+//
+// This finds the intersection of each linedef with the column and
+// row lines at the left and bottom of each blockmap cell. It then
+// adds the line to all block lists touching the intersection.
+//
+// Only the columns and rows between the line's ends are visited;
+// the original builder skipped the others one by one.
+//
+
+static void dsda_BinLine(const block_build_t* build, block_chunk_t* chunk, int i) {
+  int xorg = build->xorg;
+  int yorg = build->yorg;
+  int ncols = build->ncols;
+  int nrows = build->nrows;
+  int x1 = lines[i].v1->x>>FRACBITS;         // lines[i] map coords
+  int y1 = lines[i].v1->y>>FRACBITS;
+  int x2 = lines[i].v2->x>>FRACBITS;
+  int y2 = lines[i].v2->y>>FRACBITS;
+  int dx = x2-x1;
+  int dy = y2-y1;
+  int vert = !dx;                            // lines[i] slopetype
+  int horiz = !dy;
+  int spos = (dx^dy) > 0;
+  int sneg = (dx^dy) < 0;
+  int bx,by;                                 // block cell coords
+  int minx = x1>x2? x2 : x1;                 // extremal lines[i] coords
+  int maxx = x1>x2? x1 : x2;
+  int miny = y1>y2? y2 : y1;
+  int maxy = y1>y2? y1 : y2;
+  int j, first, last;
+
+  // The line always belongs to the blocks containing its endpoints
+
+  bx = (x1-xorg)>>blkshift;
+  by = (y1-yorg)>>blkshift;
+  dsda_AddBlockLine(chunk,by*ncols+bx,i);
+  bx = (x2-xorg)>>blkshift;
+  by = (y2-yorg)>>blkshift;
+  dsda_AddBlockLine(chunk,by*ncols+bx,i);
+
+  // For each column, see where the line along its left edge, which
+  // it contains, intersects the Linedef i. Add i to each corresponding
+  // blocklist.
+
+  if (!vert)    // don't interesect vertical lines with columns
+  {
+    first = (minx-xorg+blkmask)>>blkshift;
+    last = (maxx-xorg)>>blkshift;
+    if (first < 0)
+      first = 0;
+    if (last > ncols-1)
+      last = ncols-1;
+
+    for (j=first;j<=last;j++)
+    {
+      // intersection of Linedef with x=xorg+(j<<blkshift)
+      // (y-y1)*dx = dy*(x-x1)
+      // y = dy*(x-x1)+y1*dx;
+
+      int x = xorg+(j<<blkshift);       // (x,y) is intersection
+      int y = (dy*(x-x1))/dx+y1;
+      int yb = (y-yorg)>>blkshift;      // block row number
+      int yp = (y-yorg)&blkmask;        // y position within block
+
+      if (yb<0 || yb>nrows-1)     // outside blockmap, continue
+        continue;
+
+      // The cell that contains the intersection point is always added
+
+      dsda_AddBlockLine(chunk,ncols*yb+j,i);
+
+      // if the intersection is at a corner it depends on the slope
+      // (and whether the line extends past the intersection) which
+      // blocks are hit
+
+      if (yp==0)        // intersection at a corner
+      {
+        if (sneg)       //   \ - blocks x,y-, x-,y
+        {
+          if (yb>0 && miny<y)
+            dsda_AddBlockLine(chunk,ncols*(yb-1)+j,i);
+          if (j>0 && minx<x)
+            dsda_AddBlockLine(chunk,ncols*yb+j-1,i);
+        }
+        else if (spos)  //   / - block x-,y-
+        {
+          if (yb>0 && j>0 && minx<x)
+            dsda_AddBlockLine(chunk,ncols*(yb-1)+j-1,i);
+        }
+        else if (horiz) //   - - block x-,y
+        {
+          if (j>0 && minx<x)
+            dsda_AddBlockLine(chunk,ncols*yb+j-1,i);
+        }
+      }
+      else if (j>0 && minx<x) // else not at corner: x-,y
+        dsda_AddBlockLine(chunk,ncols*yb+j-1,i);
+    }
+  }
+
+  // For each row, see where the line along its bottom edge, which
+  // it contains, intersects the Linedef i. Add i to all the corresponding
+  // blocklists.
+
+  if (!horiz)
+  {
+    first = (miny-yorg+blkmask)>>blkshift;
+    last = (maxy-yorg)>>blkshift;
+    if (first < 0)
+      first = 0;
+    if (last > nrows-1)
+      last = nrows-1;
+
+    for (j=first;j<=last;j++)
+    {
+      // intersection of Linedef with y=yorg+(j<<blkshift)
+      // (x,y) on Linedef i satisfies: (y-y1)*dx = dy*(x-x1)
+      // x = dx*(y-y1)/dy+x1;
+
+      int y = yorg+(j<<blkshift);       // (x,y) is intersection
+      int x = (dx*(y-y1))/dy+x1;
+      int xb = (x-xorg)>>blkshift;      // block column number
+      int xp = (x-xorg)&blkmask;        // x position within block
+
+      if (xb<0 || xb>ncols-1)   // outside blockmap, continue
+        continue;
+
+      // The cell that contains the intersection point is always added
+
+      dsda_AddBlockLine(chunk,ncols*j+xb,i);
+
+      // if the intersection is at a corner it depends on the slope
+      // (and whether the line extends past the intersection) which
+      // blocks are hit
+
+      if (xp==0)        // intersection at a corner
+      {
+        if (sneg)       //   \ - blocks x,y-, x-,y
+        {
+          if (j>0 && miny<y)
+            dsda_AddBlockLine(chunk,ncols*(j-1)+xb,i);
+          if (xb>0 && minx<x)
+            dsda_AddBlockLine(chunk,ncols*j+xb-1,i);
+        }
+        else if (vert)  //   | - block x,y-
+        {
+          if (j>0 && miny<y)
+            dsda_AddBlockLine(chunk,ncols*(j-1)+xb,i);
+        }
+        else if (spos)  //   / - block x-,y-
+        {
+          if (xb>0 && j>0 && miny<y)
+            dsda_AddBlockLine(chunk,ncols*(j-1)+xb-1,i);
+        }
+      }
+      else if (j>0 && miny<y) // else not on a corner: x,y-
+        dsda_AddBlockLine(chunk,ncols*(j-1)+xb,i);
+    }
+  }
+}
+
+static void dsda_BinLines(int start, int end, void* data) {
+  block_build_t* build = data;
+  int c;
+
+  for (c = start; c < end; ++c) {
+    block_chunk_t* chunk = &build->chunks[c];
+    int i;
+
+    chunk->done = calloc(build->ncols * build->nrows, sizeof(*chunk->done));
+
+    if (!chunk->done) {
+      chunk->failed = true;
+      continue;
+    }
+
+    for (i = chunk->start; i < chunk->end && !chunk->failed; ++i)
+      dsda_BinLine(build, chunk, i);
+
+    free(chunk->done);
+    chunk->done = NULL;
+  }
+}
+
+static void dsda_BlockMapOrigin(block_build_t* build) {
+  int i;
+  int map_minx=INT_MAX;          // init for map limits search
+  int map_miny=INT_MAX;
+  int map_maxx=INT_MIN;
+  int map_maxy=INT_MIN;
+
+  // scan for map limits, which the blockmap must enclose
+
+  // This fixes MBF's code, which has a bug where maxx/maxy
+  // are wrong if the 0th node has the largest x or y
+  if (numvertexes)
+  {
+    map_minx = map_maxx = vertexes[0].x;
+    map_miny = map_maxy = vertexes[0].y;
+  }
+
+  for (i=0;i<numvertexes;i++)
+  {
+    fixed_t t;
+
+    if ((t=vertexes[i].x) < map_minx)
+      map_minx = t;
+    else if (t > map_maxx)
+      map_maxx = t;
+    if ((t=vertexes[i].y) < map_miny)
+      map_miny = t;
+    else if (t > map_maxy)
+      map_maxy = t;
+  }
+  map_minx >>= FRACBITS;    // work in map coords, not fixed_t
+  map_maxx >>= FRACBITS;
+  map_miny >>= FRACBITS;
+  map_maxy >>= FRACBITS;
+
+  // set up blockmap area to enclose level plus margin
+
+  build->xorg = map_minx-blkmargin;
+  build->yorg = map_miny-blkmargin;
+  build->ncols = (map_maxx+blkmargin-build->xorg+1+blkmask)>>blkshift;  //jff 10/12/98
+  build->nrows = (map_maxy+blkmargin-build->yorg+1+blkmask)>>blkshift;  //+1 needed for
+                                                                        //map exactly 1 cell
+}
+
+static int* dsda_BuildBlockMap(block_build_t* build, int* count) {
+  int* blockmap;
+  int* cursor;
+  int nblocks;
+  int c, i;
+  long long linetotal;
+
+  nblocks = build->ncols * build->nrows;
+
+  build->chunk_count = dsda_ThreadCount();
+  if (build->chunk_count > numlines / 256)
+    build->chunk_count = numlines / 256;
+  if (build->chunk_count < 1)
+    build->chunk_count = 1;
+
+  build->chunks = Z_Calloc(build->chunk_count, sizeof(*build->chunks));
+
+  for (c = 0; c < build->chunk_count; ++c) {
+    build->chunks[c].start = (long long) numlines * c / build->chunk_count;
+    build->chunks[c].end = (long long) numlines * (c + 1) / build->chunk_count;
+  }
+
+  dsda_ParallelFor(build->chunk_count, 1, dsda_BinLines, build);
+
+  // Every list holds a leading 0 and a trailing -1
+
+  cursor = Z_Malloc(nblocks * sizeof(*cursor));
+
+  for (i = 0; i < nblocks; ++i)
+    cursor[i] = 2;
+
+  for (c = 0; c < build->chunk_count; ++c) {
+    block_chunk_t* chunk = &build->chunks[c];
+
+    if (chunk->failed)
+      I_Error("dsda_CreateBlockMap: out of memory");
+
+    for (i = 0; i < chunk->count; ++i)
+      ++cursor[chunk->entries[i].cell];
+  }
+
+  linetotal = 0;
+  for (i = 0; i < nblocks; ++i)
+    linetotal += cursor[i];
+
+  if (4 + nblocks + linetotal > (long long) (INT_MAX / sizeof(*blockmap)))
+    I_Error("dsda_CreateBlockMap: blockmap too large");
+
+  *count = 4 + nblocks + (int) linetotal;
+  blockmap = Z_Malloc(*count * sizeof(*blockmap));
+
+  // blockmap header
+
+  blockmap[0] = build->xorg << FRACBITS;
+  blockmap[1] = build->yorg << FRACBITS;
+  blockmap[2] = build->ncols;
+  blockmap[3] = build->nrows;
+
+  // offsets to lists, each one starting with 0 and ending with -1
+
+  for (i = 0; i < nblocks; ++i) {
+    int offset = i ? blockmap[4 + i - 1] + cursor[i - 1] : 4 + nblocks;
+
+    blockmap[4 + i] = offset;
+    blockmap[offset + cursor[i] - 1] = -1;
+  }
+
+  for (i = 0; i < nblocks; ++i) {
+    blockmap[blockmap[4 + i]] = 0;
+    cursor[i] = blockmap[4 + i] + 1;
+  }
+
+  // fill the lists with the lines in descending order
+
+  for (c = build->chunk_count - 1; c >= 0; --c) {
+    block_chunk_t* chunk = &build->chunks[c];
+
+    for (i = chunk->count - 1; i >= 0; --i)
+      blockmap[cursor[chunk->entries[i].cell]++] = chunk->entries[i].line;
+
+    free(chunk->entries);
+  }
+
+  Z_Free(cursor);
+  Z_Free(build->chunks);
+  build->chunks = NULL;
+
+  return blockmap;
+}
+
+static void dsda_BlockMapCheckSum(dsda_cksum_t* cksum) {
+  struct MD5Context md5;
+  int header[3];
+  int i;
+
+  header[0] = DSDA_BLOCKMAP_VERSION;
+  header[1] = numvertexes;
+  header[2] = numlines;
+
+  MD5Init(&md5);
+  MD5Update(&md5, (const md5byte*) header, sizeof(header));
+
+  for (i = 0; i < numvertexes; ++i) {
+    int data[2];
+
+    data[0] = vertexes[i].x;
+    data[1] = vertexes[i].y;
+
+    MD5Update(&md5, (const md5byte*) data, sizeof(data));
+  }
+
+  for (i = 0; i < numlines; ++i) {
+    int data[2];
+
+    data[0] = lines[i].v1 - vertexes;
+    data[1] = lines[i].v2 - vertexes;
+
+    MD5Update(&md5, (const md5byte*) data, sizeof(data));
+  }
+
+  MD5Final(cksum->bytes, &md5);
+  dsda_TranslateCheckSum(cksum);
+}
+
+// The cache is only trusted if its layout matches this map
+static dboolean dsda_ValidCachedBlockMap(const block_build_t* build, const int* blockmap, int count) {
+  int nblocks;
+  int i, j;
+
+  nblocks = build->ncols * build->nrows;
+
+  if (count < 4 + 3 * nblocks ||
+      blockmap[0] != build->xorg << FRACBITS ||
+      blockmap[1] != build->yorg << FRACBITS ||
+      blockmap[2] != build->ncols ||
+      blockmap[3] != build->nrows)
+    return false;
+
+  for (i = 0; i < nblocks; ++i) {
+    int end = i < nblocks - 1 ? blockmap[4 + i + 1] : count;
+
+    if (blockmap[4 + i] < 4 + nblocks || end > count || end - blockmap[4 + i] < 2 ||
+        blockmap[blockmap[4 + i]] != 0 || blockmap[end - 1] != -1)
+      return false;
+
+    for (j = blockmap[4 + i] + 1; j < end - 1; ++j)
+      if (blockmap[j] < 0 || blockmap[j] >= numlines)
+        return false;
+  }
+
+  return true;
+}
+
+int* dsda_CreateBlockMap(int* count) {
+  block_build_t build = { 0 };
+  dsda_cksum_t cksum;
+  dsda_string_t path;
+  byte* buffer = NULL;
+  int length;
+
+  dsda_BlockMapOrigin(&build);
+
+  if (numlines < BLOCKMAP_CACHE_LINES)
+    return dsda_BuildBlockMap(&build, count);
+
+  dsda_BlockMapCheckSum(&cksum);
+
+  dsda_StringPrintF(&path, "%s/blockmap", dsda_DataRoot());
+  M_MakeDir(path.string, true);
+  dsda_StringCatF(&path, "/%s.dat", cksum.string);
+
+  length = M_ReadFile(path.string, &buffer);
+
+  if (buffer) {
+    if (length % sizeof(int) == 0 &&
+        dsda_ValidCachedBlockMap(&build, (int*) buffer, length / sizeof(int))) {
+      dsda_FreeString(&path);
+      *count = length / sizeof(int);
+
+      return (int*) buffer;
+    }
+
+    Z_Free(buffer);
+  }
+
+  buffer = (byte*) dsda_BuildBlockMap(&build, count);
+
+  if (!M_WriteFile(path.string, buffer, *count * sizeof(int)))
+    lprintf(LO_WARN, "dsda_CreateBlockMap: unable to write %s\n", path.string);
+
+  dsda_FreeString(&path);
+
+  return (int*) buffer;
+}
@@ -17,13 +17,29 @@
 
 #include <math.h>
 
+#ifndef _WIN32
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include "d_player.h"
+#include "p_map.h"
+#include "p_mobj.h"
+#include "p_spec.h"
+#include "p_tick.h"
 #include "d_ticcmd.h"
 #include "doomstat.h"
+#include "g_game.h"
+#include "i_main.h"
 #include "lprintf.h"
+#include "m_bbox.h"
 #include "m_random.h"
 #include "r_state.h"
 
+#include "dsda/args.h"
 #include "dsda/build.h"
 #include "dsda/features.h"
 #include "dsda/key_frame.h"
@@ -35,6 +51,11 @@
 
 #define MAX_BF_DEPTH 35
 #define MAX_BF_CONDITIONS 16
+#define MAX_BF_WORKERS 256
+#define BF_REPORT_INTERVAL 10000
+#define DEFAULT_BF_BEAM_WIDTH 64
+#define DEFAULT_BF_RANDOM_VOLUME 100000
+#define BF_STEP_HEIGHT (24 * FRACUNIT)
 
 typedef struct {
   int min;
@@ -42,6 +63,12 @@ typedef struct {
   int i;
 } bf_range_t;
 
+typedef struct {
+  int forwardmove;
+  int sidemove;
+  int angleturn;
+} bf_command_t;
+
 typedef struct {
   dsda_key_frame_t key_frame;
   bf_range_t forwardmove;
@@ -65,9 +92,35 @@ typedef struct {
   dboolean evaluated;
   fixed_t best_value;
   int best_depth;
+  long long best_index;
   bf_t best_bf[MAX_BF_DEPTH];
 } bf_target_t;
 
+typedef struct {
+  dsda_key_frame_t key_frame;
+  fixed_t score;
+  bf_command_t path[MAX_BF_DEPTH];
+} bf_beam_entry_t;
+
+typedef enum {
+  bf_message_progress,
+  bf_message_result,
+} bf_message_type_t;
+
+typedef struct {
+  bf_message_type_t type;
+  long long volume;
+  long long pruned;
+  long long tics_saved;
+  int result;
+  long long index;
+  dboolean evaluated;
+  fixed_t best_value;
+  int best_depth;
+  int best_condition_count;
+  ticcmd_t cmds[MAX_BF_DEPTH];
+} bf_message_t;
+
 static bf_t brute_force[MAX_BF_DEPTH];
 static int bf_depth;
 static int bf_logictic;
@@ -75,6 +128,34 @@ static int bf_condition_count;
 static bf_condition_t bf_condition[MAX_BF_CONDITIONS];
 static long long bf_volume;
 static long long bf_volume_max;
+static long long bf_index_start;
+static long long bf_index;
+static int bf_worker_fd = -1;
+static long long bf_pruned;
+static long long bf_tics_saved;
+static long long bf_next_report;
+static long long bf_subtree_volume[MAX_BF_DEPTH + 1];
+static dsda_bf_engine_t bf_engine;
+static int bf_engine_parameter;
+
+static bf_beam_entry_t* bf_beam[2];
+static int bf_beam_count[2];
+static int bf_beam_size;
+static int bf_beam_width;
+static int bf_beam_current;
+static int bf_beam_level;
+static int bf_beam_parent;
+
+static bf_command_t bf_run_path[MAX_BF_DEPTH];
+static bf_command_t bf_random_path[MAX_BF_DEPTH];
+static bf_command_t bf_random_best_path[MAX_BF_DEPTH];
+static dboolean bf_random_valid;
+static fixed_t bf_random_score;
+static dboolean bf_random_best_valid;
+static fixed_t bf_random_best_score;
+static int bf_random_stall;
+static int bf_random_restarts;
+static unsigned int bf_random_state;
 static dboolean bf_mode;
 static bf_target_t bf_target;
 static ticcmd_t bf_result[MAX_BF_DEPTH];
@@ -110,6 +191,13 @@ const char* dsda_bf_limit_names[dsda_bf_limit_max] = {
   "min",
 };
 
+const char* dsda_bf_engine_names[dsda_bf_engine_max] = {
+  [dsda_bf_exhaustive] = "exhaustive",
+  [dsda_bf_depth_first] = "dfs",
+  [dsda_bf_beam] = "beam",
+  [dsda_bf_random] = "random",
+};
+
 static dboolean fixed_point_attribute[dsda_bf_attribute_max] = {
   [dsda_bf_x] = true,
   [dsda_bf_y] = true,
@@ -141,16 +229,70 @@ static dboolean dsda_AdvanceBruteForceFrame(int frame) {
   return true;
 }
 
-static int dsda_AdvanceBruteForce(void) {
+static long long dsda_SetBFRangeIndex(bf_range_t* range, long long index) {
+  int size;
+
+  size = range->max - range->min + 1;
+  range->i = range->min + index % size;
+
+  return index / size;
+}
+
+// Candidates are ordered as in dsda_AdvanceBruteForce, with the last frame's turn varying fastest
+static void dsda_SetBFIndex(long long index) {
   int i;
 
-  for (i = bf_depth - 1; i >= 0; --i)
+  for (i = bf_depth - 1; i >= 0; --i) {
+    index = dsda_SetBFRangeIndex(&brute_force[i].angleturn, index);
+    index = dsda_SetBFRangeIndex(&brute_force[i].sidemove, index);
+    index = dsda_SetBFRangeIndex(&brute_force[i].forwardmove, index);
+  }
+}
+
+static int dsda_AdvanceBruteForceFrom(int frame) {
+  int i;
+
+  for (i = frame; i >= 0; --i)
     if (dsda_AdvanceBruteForceFrame(i))
       break;
 
   return i;
 }
 
+static int dsda_AdvanceBruteForce(void) {
+  return dsda_AdvanceBruteForceFrom(bf_depth - 1);
+}
+
+static int dsda_BFRangeVolume(bf_range_t* range) {
+  return range->max - range->min + 1;
+}
+
+static long long dsda_BFFrameVolume(int frame) {
+  return (long long) dsda_BFRangeVolume(&brute_force[frame].forwardmove) *
+                     dsda_BFRangeVolume(&brute_force[frame].sidemove) *
+                     dsda_BFRangeVolume(&brute_force[frame].angleturn);
+}
+
+static void dsda_GetBFPath(bf_command_t* path, int depth) {
+  int i;
+
+  for (i = 0; i < depth; ++i) {
+    path[i].forwardmove = brute_force[i].forwardmove.i;
+    path[i].sidemove = brute_force[i].sidemove.i;
+    path[i].angleturn = brute_force[i].angleturn.i;
+  }
+}
+
+static void dsda_SetBFPath(const bf_command_t* path, int depth) {
+  int i;
+
+  for (i = 0; i < depth; ++i) {
+    brute_force[i].forwardmove.i = path[i].forwardmove;
+    brute_force[i].sidemove.i = path[i].sidemove;
+    brute_force[i].angleturn.i = path[i].angleturn;
+  }
+}
+
 static void dsda_CopyBFCommandDepth(ticcmd_t* cmd, bf_t* bf) {
   memset(cmd, 0, sizeof(*cmd));
 
@@ -170,23 +312,39 @@ static void dsda_CopyBFResult(bf_t* bf, int depth) {
     memset(&bf_result[i], 0, sizeof(ticcmd_t) * (MAX_BF_DEPTH - i));
 }
 
+// Only the tics after the restored frame are replayed
 static void dsda_RestoreBFKeyFrame(int frame) {
   dsda_RestoreKeyFrame(&brute_force[frame].key_frame, true);
+
+  bf_tics_saved += frame;
 }
 
 static void dsda_StoreBFKeyFrame(int frame) {
-  dsda_StoreKeyFrame(&brute_force[frame].key_frame, true, false);
+  dsda_StoreKeyFrame(&brute_force[frame].key_frame, true, false, thinker_format_compact);
 }
 
+static void dsda_BFBestString(char* str, size_t size);
+
 static void dsda_PrintBFProgress(void) {
   int percent;
   unsigned long long elapsed_time;
+  long long tested;
+  double seconds;
+  char best_str[FIXED_STRING_LENGTH + 16];
 
   percent = 100 * bf_volume / bf_volume_max;
   elapsed_time = dsda_ElapsedTimeMS(dsda_timer_brute_force);
 
   lprintf(LO_INFO, "  %lld / %lld sequences tested (%d%%) in %.2f seconds!\n",
           bf_volume, bf_volume_max, percent, (float) elapsed_time / 1000);
+
+  tested = bf_volume - bf_pruned;
+  seconds = elapsed_time ? (double) elapsed_time / 1000 : 0.001;
+  dsda_BFBestString(best_str, sizeof(best_str));
+
+  lprintf(LO_INFO, "  %s: %.0f sequences / second, %.1f%% pruned, %lld tics saved, best %s\n",
+          dsda_bf_engine_names[bf_engine], tested / seconds,
+          bf_volume ? 100.0 * bf_pruned / bf_volume : 0.0, bf_tics_saved, best_str);
 }
 
 #define BF_FAILURE 0
@@ -199,6 +357,25 @@ dboolean dsda_BruteForceEnded(void) {
   return brute_force_ended;
 }
 
+static void dsda_FreeBFBeam(void) {
+  int i, j;
+
+  for (i = 0; i < 2; ++i) {
+    if (!bf_beam[i])
+      continue;
+
+    for (j = 0; j < bf_beam_size; ++j)
+      if (bf_beam[i][j].key_frame.buffer)
+        Z_Free(bf_beam[i][j].key_frame.buffer);
+
+    Z_Free(bf_beam[i]);
+    bf_beam[i] = NULL;
+    bf_beam_count[i] = 0;
+  }
+
+  bf_beam_size = 0;
+}
+
 static void dsda_EndBF(int result) {
   brute_force_ended = true;
 
@@ -206,6 +383,7 @@ static void dsda_EndBF(int result) {
   dsda_PrintBFProgress();
 
   dsda_RestoreBFKeyFrame(0);
+  dsda_FreeBFBeam();
 
   bf_mode = false;
 
@@ -283,24 +461,19 @@ static dboolean dsda_BFConditionReached(int i) {
   }
 }
 
-static void dsda_BFUpdateBestResult(fixed_t value) {
-  int i;
-  char str[FIXED_STRING_LENGTH];
-  char cmd_str[COMMAND_MOVEMENT_STRING_LENGTH];
-
-  bf_target.evaluated = true;
-  bf_target.best_value = value;
-  bf_target.best_depth = logictic - bf_logictic;
-
-  for (i = 0; i < bf_target.best_depth; ++i)
-    bf_target.best_bf[i] = brute_force[i];
-
-  dsda_CopyBFResult(bf_target.best_bf, bf_target.best_depth);
-
+static void dsda_BFValueString(char* str, fixed_t value) {
   if (fixed_point_attribute[bf_target.attribute])
     dsda_FixedToString(str, value);
   else
     snprintf(str, FIXED_STRING_LENGTH, "%i", value);
+}
+
+static void dsda_PrintBFBestResult(fixed_t value) {
+  int i;
+  char str[FIXED_STRING_LENGTH];
+  char cmd_str[COMMAND_MOVEMENT_STRING_LENGTH];
+
+  dsda_BFValueString(str, value);
 
   lprintf(LO_INFO, "New best: %s = %s\n", dsda_bf_attribute_names[bf_target.attribute], str);
 
@@ -312,22 +485,43 @@ static void dsda_BFUpdateBestResult(fixed_t value) {
   lprintf(LO_INFO, "\n");
 }
 
-static dboolean dsda_BFNewBestResult(fixed_t value) {
-  if (!bf_target.evaluated)
-    return true;
+static void dsda_BFUpdateBestResult(fixed_t value) {
+  int i;
+
+  bf_target.evaluated = true;
+  bf_target.best_value = value;
+  bf_target.best_depth = logictic - bf_logictic;
+  bf_target.best_index = bf_index;
+
+  for (i = 0; i < bf_target.best_depth; ++i)
+    bf_target.best_bf[i] = brute_force[i];
+
+  dsda_CopyBFResult(bf_target.best_bf, bf_target.best_depth);
+
+  if (bf_worker_fd < 0)
+    dsda_PrintBFBestResult(value);
+}
 
+static dboolean dsda_BFBetterValue(fixed_t value, fixed_t best_value) {
   switch (bf_target.limit) {
     case dsda_bf_acap:
-      return abs(value - bf_target.value) < abs(bf_target.best_value - bf_target.value);
+      return abs(value - bf_target.value) < abs(best_value - bf_target.value);
     case dsda_bf_max:
-      return value > bf_target.best_value;
+      return value > best_value;
     case dsda_bf_min:
-      return value < bf_target.best_value;
+      return value < best_value;
     default:
       return false;
   }
 }
 
+static dboolean dsda_BFNewBestResult(fixed_t value) {
+  if (!bf_target.evaluated)
+    return true;
+
+  return dsda_BFBetterValue(value, bf_target.best_value);
+}
+
 static void dsda_BFEvaluateTarget(void) {
   fixed_t value;
 
@@ -354,10 +548,371 @@ static dboolean dsda_BFConditionsReached(void) {
   return reached == bf_condition_count;
 }
 
+static int bf_best_condition_count = -1;
+
+static int dsda_BFConditionCount(void) {
+  int i, reached;
+
+  reached = 0;
+  for (i = 0; i < bf_condition_count; ++i)
+    reached += dsda_BFConditionReached(i);
+
+  return reached;
+}
+
+static void dsda_BFUpdateBestConditionCount(void) {
+  int reached;
+
+  if (bf_target.enabled)
+    return;
+
+  reached = dsda_BFConditionCount();
+
+  if (reached > bf_best_condition_count)
+    bf_best_condition_count = reached;
+}
+
+static void dsda_BFBestString(char* str, size_t size) {
+  char value_str[FIXED_STRING_LENGTH];
+
+  if (bf_target.enabled && bf_target.evaluated) {
+    dsda_BFValueString(value_str, bf_target.best_value);
+    snprintf(str, size, "%s = %s", dsda_bf_attribute_names[bf_target.attribute], value_str);
+  }
+  else if (!bf_target.enabled && bf_best_condition_count >= 0)
+    snprintf(str, size, "%d / %d conditions", bf_best_condition_count, bf_condition_count);
+  else
+    snprintf(str, size, "none");
+}
+
+// Heuristic engines rank states by the target, or by the number of conditions reached
+static fixed_t dsda_BFScore(void) {
+  if (bf_target.enabled)
+    return dsda_BFAttribute(bf_target.attribute);
+
+  return dsda_BFConditionCount();
+}
+
+static dboolean dsda_BFBetterScore(fixed_t score, fixed_t best_score) {
+  if (bf_target.enabled)
+    return dsda_BFBetterValue(score, best_score);
+
+  return score > best_score;
+}
+
+// Upper bound on how far an attribute can change in the remaining frames,
+//   assuming normal friction and no outside forces acting on the player
+//   (see dsda_FindBFOutsideForces)
+static long long dsda_BFReach(dsda_bf_attribute_t attribute, int frame) {
+  mobj_t* mo;
+  long long reach;
+  fixed_t speed;
+  int i;
+
+  mo = players[displayplayer].mo;
+  reach = 0;
+
+  switch (attribute) {
+    case dsda_bf_x:
+    case dsda_bf_y:
+      speed = abs(attribute == dsda_bf_x ? mo->momx : mo->momy);
+
+      for (i = frame; i < bf_depth; ++i) {
+        int forwardmove, sidemove;
+
+        forwardmove = MAX(abs(brute_force[i].forwardmove.min), abs(brute_force[i].forwardmove.max));
+        sidemove = MAX(abs(brute_force[i].sidemove.min), abs(brute_force[i].sidemove.max));
+
+        speed += (forwardmove + sidemove) * ORIG_FRICTION_FACTOR;
+        if (speed > MAXMOVE)
+          speed = MAXMOVE;
+
+        reach += speed;
+      }
+      break;
+    case dsda_bf_z:
+      speed = abs(mo->momz);
+
+      for (i = frame; i < bf_depth; ++i) {
+        speed += GRAVITY;
+        reach += speed + BF_STEP_HEIGHT;
+      }
+      break;
+    default:
+      return -1;
+  }
+
+  return reach;
+}
+
+// Reasons the player might move in ways the reach bounds don't cover
+static const char* bf_outside_force;
+static int* bf_special_lines;
+static int bf_special_line_count;
+
+// Splash damage radius of rockets and barrels
+#define BF_SPLASH_RADIUS (128 * FRACUNIT)
+
+static dboolean dsda_BFHarmlessThinker(thinker_t* th) {
+  return th->function == P_RemoveThinkerDelayed ||
+         th->function == T_LightFlash ||
+         th->function == T_StrobeFlash ||
+         th->function == T_FireFlicker ||
+         th->function == T_Glow ||
+         th->function == T_ZDoom_Glow ||
+         th->function == T_ZDoom_Flicker;
+}
+
+// Everywhere the player could be during the search, grown by their radius
+static long long bf_reach_box[4];
+
+static dboolean dsda_BFBoxInReach(long long top, long long bottom, long long left, long long right) {
+  return left <= bf_reach_box[BOXRIGHT] && right >= bf_reach_box[BOXLEFT] &&
+         bottom <= bf_reach_box[BOXTOP] && top >= bf_reach_box[BOXBOTTOM];
+}
+
+static dboolean dsda_BFPointInReach(fixed_t x, fixed_t y, long long range) {
+  return dsda_BFBoxInReach((long long) y + range, (long long) y - range,
+                           (long long) x - range, (long long) x + range);
+}
+
+static dboolean dsda_BFSectorInReach(sector_t* sector) {
+  int i;
+
+  for (i = 0; i < sector->linecount; ++i) {
+    line_t* line = sector->lines[i];
+
+    if (dsda_BFBoxInReach(line->bbox[BOXTOP], line->bbox[BOXBOTTOM],
+                          line->bbox[BOXLEFT], line->bbox[BOXRIGHT]))
+      return true;
+  }
+
+  // The player may be inside the sector without touching its lines
+  {
+    subsector_t* subsector = players[displayplayer].mo->subsector;
+
+    return subsector && subsector->sector == sector;
+  }
+}
+
+// A thing can travel this far per tic, whether by momentum or by walking
+static long long dsda_BFThingTravel(mobj_t* mo) {
+  fixed_t speed;
+
+  speed = mo->info->speed;
+  if (speed < FRACUNIT)
+    speed <<= FRACBITS;
+
+  return (long long) MAX(speed, MAXMOVE) * bf_depth;
+}
+
+// A monster can walk, then shoot a hitscan or a projectile that explodes
+static dboolean dsda_BFThingInReach(mobj_t* mo) {
+  long long range;
+
+  range = dsda_BFThingTravel(mo) + mo->radius + BF_SPLASH_RADIUS;
+
+  if (mo->flags & MF_SHOOTABLE)
+    range += MISSILERANGE + (long long) MAXMOVE * bf_depth;
+
+  return dsda_BFPointInReach(mo->x, mo->y, range);
+}
+
+// Returns NULL for thinkers that can't reach the player, else a reason
+static const char* dsda_BFThinkerForce(thinker_t* th) {
+  sector_t* sector = NULL;
+
+  if (th->function == T_MoveFloor)
+    sector = ((floormove_t*) th)->sector;
+  else if (th->function == T_MoveCeiling)
+    sector = ((ceiling_t*) th)->sector;
+  else if (th->function == T_PlatRaise)
+    sector = ((plat_t*) th)->sector;
+  else if (th->function == T_VerticalDoor)
+    sector = ((vldoor_t*) th)->sector;
+  else if (th->function == T_MoveElevator)
+    sector = ((elevator_t*) th)->sector;
+  else if (th->function == T_Friction)
+    sector = &sectors[((friction_t*) th)->affectee];
+  else if (th->function == T_Scroll) {
+    scroll_t* scroll = (scroll_t*) th;
+
+    // Other scrollers only move textures
+    if (scroll->type != sc_carry && scroll->type != sc_carry_ceiling)
+      return NULL;
+
+    sector = &sectors[scroll->affectee];
+  }
+  else if (th->function == T_Pusher) {
+    pusher_t* pusher = (pusher_t*) th;
+
+    if (pusher->type == p_push || pusher->type == p_pull)
+      return dsda_BFPointInReach(pusher->x, pusher->y, pusher->radius) ? "point pushers" : NULL;
+
+    sector = &sectors[pusher->affectee];
+  }
+  else
+    return "unknown thinkers";
+
+  return dsda_BFSectorInReach(sector) ? "moving sectors, scrollers, or pushers" : NULL;
+}
+
+// Finds anything that can push, carry, or hurt the player before the search
+//   ends, since the reach bounds only cover the player's own movement.
+//   Things and sectors out of range of the whole search are ignored.
+static void dsda_FindBFOutsideForces(void) {
+  thinker_t* th;
+  mobj_t* player_mo;
+  long long reach_x, reach_y;
+  int i;
+
+  bf_outside_force = NULL;
+  bf_special_line_count = 0;
+
+  if (raven) {
+    bf_outside_force = "sector currents and scripts";
+    return;
+  }
+
+  player_mo = players[displayplayer].mo;
+
+  if (players[displayplayer].weaponowned[wp_missile])
+    for (i = 0; i < bf_depth; ++i)
+      if (brute_force[i].buttons & BT_ATTACK) {
+        bf_outside_force = "rocket splash";
+        return;
+      }
+
+  reach_x = dsda_BFReach(dsda_bf_x, 0) + player_mo->radius;
+  reach_y = dsda_BFReach(dsda_bf_y, 0) + player_mo->radius;
+  bf_reach_box[BOXTOP] = player_mo->y + reach_y;
+  bf_reach_box[BOXBOTTOM] = player_mo->y - reach_y;
+  bf_reach_box[BOXLEFT] = player_mo->x - reach_x;
+  bf_reach_box[BOXRIGHT] = player_mo->x + reach_x;
+
+  for (th = thinkercap.next; th != &thinkercap; th = th->next) {
+    if (th->function == P_MobjThinker) {
+      mobj_t* mo = (mobj_t*) th;
+
+      if (
+        mo != player_mo &&
+        mo->flags & (MF_SHOOTABLE | MF_MISSILE) &&
+        dsda_BFThingInReach(mo)
+      ) {
+        bf_outside_force = "things that can deal damage";
+        return;
+      }
+    }
+    else if (!dsda_BFHarmlessThinker(th)) {
+      bf_outside_force = dsda_BFThinkerForce(th);
+
+      if (bf_outside_force)
+        return;
+    }
+  }
+
+  // Line specials are checked by distance while searching
+  bf_special_lines = Z_Realloc(bf_special_lines, numlines * sizeof(*bf_special_lines));
+
+  for (i = 0; i < numlines; ++i)
+    if (lines[i].special)
+      bf_special_lines[bf_special_line_count++] = i;
+}
+
+// A line special the player can cross, use, or shoot may teleport or lift them
+static dboolean dsda_BFSpecialLineInReach(int frame) {
+  mobj_t* mo;
+  long long reach_x, reach_y, range;
+  int i;
+
+  if (!bf_special_line_count)
+    return false;
+
+  mo = players[displayplayer].mo;
+  range = mo->radius + USERANGE;
+
+  for (i = frame; i < bf_depth; ++i)
+    if (brute_force[i].buttons & BT_ATTACK) {
+      range = mo->radius + MISSILERANGE;
+      break;
+    }
+
+  reach_x = dsda_BFReach(dsda_bf_x, frame) + range;
+  reach_y = dsda_BFReach(dsda_bf_y, frame) + range;
+
+  for (i = 0; i < bf_special_line_count; ++i) {
+    line_t* line = &lines[bf_special_lines[i]];
+
+    if (
+      line->bbox[BOXLEFT] <= mo->x + reach_x &&
+      line->bbox[BOXRIGHT] >= mo->x - reach_x &&
+      line->bbox[BOXBOTTOM] <= mo->y + reach_y &&
+      line->bbox[BOXTOP] >= mo->y - reach_y
+    )
+      return true;
+  }
+
+  return false;
+}
+
+static dboolean dsda_BFConditionUnreachable(int i, int frame) {
+  long long reach, low, high, value;
+
+  if (bf_condition[i].operator == dsda_bf_operator_misc)
+    return false;
+
+  reach = dsda_BFReach(bf_condition[i].attribute, frame);
+
+  if (reach < 0)
+    return false;
+
+  value = dsda_BFAttribute(bf_condition[i].attribute);
+  low = value - reach;
+  high = value + reach;
+
+  switch (bf_condition[i].operator) {
+    case dsda_bf_less_than:
+      return low >= bf_condition[i].value;
+    case dsda_bf_less_than_or_equal_to:
+      return low > bf_condition[i].value;
+    case dsda_bf_greater_than:
+      return high <= bf_condition[i].value;
+    case dsda_bf_greater_than_or_equal_to:
+      return high < bf_condition[i].value;
+    case dsda_bf_equal_to:
+      return bf_condition[i].value < low || bf_condition[i].value > high;
+    default:
+      return false;
+  }
+}
+
+static dboolean dsda_BFPrune(int frame) {
+  int i;
+
+  if (bf_outside_force || dsda_BFSpecialLineInReach(frame))
+    return false;
+
+  for (i = 0; i < bf_condition_count; ++i)
+    if (dsda_BFConditionUnreachable(i, frame))
+      return true;
+
+  return false;
+}
+
 dboolean dsda_BruteForce(void) {
   return bf_mode;
 }
 
+void dsda_SetBruteForceEngine(dsda_bf_engine_t engine, int parameter) {
+  bf_engine = engine;
+  bf_engine_parameter = parameter;
+
+  if (parameter)
+    lprintf(LO_INFO, "Set brute force engine: %s %d\n", dsda_bf_engine_names[engine], parameter);
+  else
+    lprintf(LO_INFO, "Set brute force engine: %s\n", dsda_bf_engine_names[engine]);
+}
+
 void dsda_ResetBruteForceConditions(void) {
   bf_condition_count = 0;
   memset(&bf_target, 0, sizeof(bf_target));
@@ -460,77 +1015,758 @@ int dsda_AddBruteForceFrame(int i,
   return true;
 }
 
-dboolean dsda_StartBruteForce(int depth) {
-  int i;
+#ifndef _WIN32
 
-  if (depth <= 0 || depth > MAX_BF_DEPTH)
-    return false;
+typedef struct {
+  pid_t pid;
+  int fd;
+  dboolean done;
+  dboolean stopped;
+  long long volume;
+  long long pruned;
+  long long tics_saved;
+  int best_condition_count;
+  bf_message_t result;
+} bf_worker_t;
+
+static void dsda_SendBFMessage(bf_message_type_t type, int result) {
+  bf_message_t message;
+  const byte* p;
+  size_t remaining;
+
+  memset(&message, 0, sizeof(message));
+  message.type = type;
+  message.volume = bf_volume;
+  message.pruned = bf_pruned;
+  message.tics_saved = bf_tics_saved;
+  message.result = result;
+  message.index = bf_target.enabled ? bf_target.best_index : bf_index;
+  message.evaluated = bf_target.evaluated;
+  message.best_value = bf_target.best_value;
+  message.best_depth = bf_target.best_depth;
+  message.best_condition_count = bf_best_condition_count;
+  memcpy(message.cmds, bf_result, sizeof(message.cmds));
+
+  p = (const byte*) &message;
+  remaining = sizeof(message);
+  while (remaining) {
+    ssize_t count;
+
+    count = write(bf_worker_fd, p, remaining);
+
+    if (count <= 0)
+      _exit(1);
+
+    p += count;
+    remaining -= count;
+  }
+}
 
-  dsda_TrackFeature(uf_bruteforce);
+static dboolean dsda_ReadBFMessage(int fd, bf_message_t* message) {
+  byte* p;
+  size_t remaining;
 
-  lprintf(LO_INFO, "Brute force starting:\n");
+  p = (byte*) message;
+  remaining = sizeof(*message);
+  while (remaining) {
+    ssize_t count;
 
-  bf_depth = depth;
-  bf_logictic = logictic;
-  bf_volume = 0;
-  bf_volume_max = 1;
+    count = read(fd, p, remaining);
 
-  for (i = 0; i < bf_depth; ++i) {
-    lprintf(LO_INFO, "  %d: F %d:%d S %d:%d T %d:%d B %d\n", i,
-            brute_force[i].forwardmove.min, brute_force[i].forwardmove.max,
-            brute_force[i].sidemove.min, brute_force[i].sidemove.max,
-            brute_force[i].angleturn.min, brute_force[i].angleturn.max,
-            brute_force[i].buttons);
+    if (count <= 0)
+      return false;
 
-    bf_volume_max *= (brute_force[i].forwardmove.max - brute_force[i].forwardmove.min + 1) *
-                     (brute_force[i].sidemove.max - brute_force[i].sidemove.min + 1) *
-                     (brute_force[i].angleturn.max - brute_force[i].angleturn.min + 1);
+    p += count;
+    remaining -= count;
   }
 
-  lprintf(LO_INFO, "Testing %lld sequences with depth %d\n\n", bf_volume_max, bf_depth);
+  return true;
+}
 
-  bf_mode = true;
+static void dsda_EndBFWorker(int result) {
+  dsda_SendBFMessage(bf_message_result, result);
+  _exit(0);
+}
 
-  dsda_EnterSkipMode();
+// Workers never return to the main loop, so they never touch the window or audio
+static void dsda_RunBFWorker(int fd, long long start, long long count) {
+  bf_worker_fd = fd;
+  bf_index_start = start;
+  bf_volume_max = count;
 
-  dsda_StartTimer(dsda_timer_brute_force);
+  dsda_SetBFIndex(start);
 
-  return true;
+  while (1) {
+    G_Ticker();
+    ++gametic;
+  }
 }
 
-void dsda_UpdateBruteForce(void) {
-  int frame;
+static void dsda_StopBFWorkers(bf_worker_t* workers, int first, int count) {
+  int i;
 
-  frame = logictic - bf_logictic;
+  for (i = first; i < count; ++i)
+    if (!workers[i].done) {
+      kill(workers[i].pid, SIGKILL);
+      workers[i].done = true;
+      workers[i].stopped = true;
+    }
+}
 
-  if (frame == bf_depth) {
-    if (bf_volume % 10000 == 0)
+static void dsda_MergeBFWorkers(bf_worker_t* workers, int count) {
+  bf_message_t* best = NULL;
+  int i;
+
+  bf_volume = 0;
+  bf_pruned = 0;
+  bf_tics_saved = 0;
+  for (i = 0; i < count; ++i) {
+    bf_volume += workers[i].volume;
+    bf_pruned += workers[i].pruned;
+    bf_tics_saved += workers[i].tics_saved;
+  }
+
+  // Workers hold consecutive slices, so the first success or strict improvement
+  //   in worker order is the same candidate the serial search would pick
+  for (i = 0; i < count; ++i) {
+    bf_message_t* result;
+
+    if (workers[i].stopped)
+      continue;
+
+    result = &workers[i].result;
+
+    if (bf_target.enabled) {
+      if (result->evaluated && (!best || dsda_BFBetterValue(result->best_value, best->best_value)))
+        best = result;
+    }
+    else if (result->result == BF_SUCCESS) {
+      best = result;
+      break;
+    }
+  }
+
+  if (!best) {
+    dsda_EndBF(BF_FAILURE);
+    return;
+  }
+
+  memcpy(bf_result, best->cmds, sizeof(bf_result));
+
+  if (bf_target.enabled) {
+    bf_target.evaluated = true;
+    bf_target.best_value = best->best_value;
+    bf_target.best_depth = best->best_depth;
+    bf_target.best_index = best->index;
+
+    dsda_PrintBFBestResult(best->best_value);
+  }
+
+  dsda_EndBF(BF_SUCCESS);
+}
+
+static void dsda_RunBFWorkers(int count) {
+  bf_worker_t* workers;
+  struct pollfd* fds;
+  int* fd_worker;
+  long long start;
+  unsigned long long last_print;
+  int pending;
+  int i;
+
+  lprintf(LO_INFO, "Splitting search across %d workers\n\n", count);
+
+  // The parent restores this frame when the search ends
+  dsda_StoreBFKeyFrame(0);
+
+  workers = Z_Calloc(count, sizeof(*workers));
+  fds = Z_Calloc(count, sizeof(*fds));
+  fd_worker = Z_Calloc(count, sizeof(*fd_worker));
+
+  start = 0;
+  for (i = 0; i < count; ++i) {
+    long long slice;
+    int pipe_fds[2];
+
+    slice = bf_volume_max / count + (i < bf_volume_max % count);
+
+    if (pipe(pipe_fds))
+      I_Error("dsda_RunBFWorkers: unable to create pipe");
+
+    workers[i].pid = fork();
+
+    if (workers[i].pid == -1)
+      I_Error("dsda_RunBFWorkers: unable to fork worker");
+
+    if (workers[i].pid == 0) {
+      int j;
+
+      for (j = 0; j < i; ++j)
+        close(workers[j].fd);
+
+      close(pipe_fds[0]);
+      dsda_RunBFWorker(pipe_fds[1], start, slice);
+    }
+
+    close(pipe_fds[1]);
+    workers[i].fd = pipe_fds[0];
+    start += slice;
+  }
+
+  last_print = 0;
+  pending = count;
+  while (pending) {
+    int fd_count;
+    unsigned long long elapsed_time;
+
+    if (I_Interrupted()) {
+      dsda_StopBFWorkers(workers, 0, count);
+      I_SafeExit(0);
+    }
+
+    fd_count = 0;
+    for (i = 0; i < count; ++i)
+      if (!workers[i].done) {
+        fds[fd_count].fd = workers[i].fd;
+        fds[fd_count].events = POLLIN;
+        fds[fd_count].revents = 0;
+        fd_worker[fd_count] = i;
+        ++fd_count;
+      }
+
+    if (poll(fds, fd_count, 100) > 0) {
+      int fd_i;
+
+      for (fd_i = 0; fd_i < fd_count; ++fd_i) {
+        bf_message_t message;
+
+        i = fd_worker[fd_i];
+
+        if (workers[i].done)
+          continue;
+
+        if (fds[fd_i].revents) {
+          if (!dsda_ReadBFMessage(workers[i].fd, &message)) {
+            dsda_StopBFWorkers(workers, 0, count);
+            I_Error("dsda_RunBFWorkers: worker %d exited unexpectedly", i);
+          }
+
+          workers[i].volume = message.volume;
+          workers[i].pruned = message.pruned;
+          workers[i].tics_saved = message.tics_saved;
+          workers[i].best_condition_count = message.best_condition_count;
+
+          if (message.type == bf_message_result) {
+            workers[i].result = message;
+            workers[i].done = true;
+
+            // Later slices cannot contain an earlier success
+            if (!bf_target.enabled && message.result == BF_SUCCESS)
+              dsda_StopBFWorkers(workers, i + 1, count);
+          }
+        }
+      }
+    }
+
+    pending = 0;
+    bf_volume = 0;
+    bf_pruned = 0;
+    bf_tics_saved = 0;
+    for (i = 0; i < count; ++i) {
+      pending += !workers[i].done;
+      bf_volume += workers[i].volume;
+      bf_pruned += workers[i].pruned;
+      bf_tics_saved += workers[i].tics_saved;
+      if (workers[i].best_condition_count > bf_best_condition_count)
+        bf_best_condition_count = workers[i].best_condition_count;
+    }
+
+    elapsed_time = dsda_ElapsedTimeMS(dsda_timer_brute_force);
+    if (pending && elapsed_time - last_print >= 1000) {
+      last_print = elapsed_time;
       dsda_PrintBFProgress();
+    }
+  }
+
+  for (i = 0; i < count; ++i) {
+    close(workers[i].fd);
+    waitpid(workers[i].pid, NULL, 0);
+  }
+
+  dsda_MergeBFWorkers(workers, count);
+
+  Z_Free(fd_worker);
+  Z_Free(fds);
+  Z_Free(workers);
+}
+
+#endif
+
+static void dsda_FinishBF(int result) {
+#ifndef _WIN32
+  if (bf_worker_fd >= 0)
+    dsda_EndBFWorker(result);
+#endif
+
+  dsda_EndBF(result);
+}
+
+static int dsda_BFExhaustedResult(void) {
+  return bf_target.enabled && bf_target.evaluated ? BF_SUCCESS : BF_FAILURE;
+}
+
+static void dsda_ReportBFProgress(void) {
+  if (bf_volume < bf_next_report)
+    return;
+
+  bf_next_report = bf_volume - bf_volume % BF_REPORT_INTERVAL + BF_REPORT_INTERVAL;
+
+#ifndef _WIN32
+  if (bf_worker_fd >= 0) {
+    dsda_SendBFMessage(bf_message_progress, BF_FAILURE);
+    return;
+  }
+#endif
+
+  dsda_PrintBFProgress();
+}
+
+// Skips the rest of the subtree below the previous frame, returning the frame to restore
+static int dsda_PruneBFSubtree(int frame) {
+  long long skipped;
+  int i;
+
+  skipped = bf_subtree_volume[frame] - (bf_index_start + bf_volume) % bf_subtree_volume[frame];
+
+  for (i = frame; i < bf_depth; ++i) {
+    brute_force[i].forwardmove.i = brute_force[i].forwardmove.min;
+    brute_force[i].sidemove.i = brute_force[i].sidemove.min;
+    brute_force[i].angleturn.i = brute_force[i].angleturn.min;
+  }
+
+  bf_volume += skipped;
+  bf_pruned += skipped;
+
+  if (bf_volume >= bf_volume_max) {
+    bf_pruned -= bf_volume - bf_volume_max;
+    bf_volume = bf_volume_max;
+
+    return -1;
+  }
+
+  return dsda_AdvanceBruteForceFrom(frame - 1);
+}
+
+static void dsda_UpdateExhaustiveBF(int frame) {
+  if (frame == bf_depth) {
+    dsda_ReportBFProgress();
 
     frame = dsda_AdvanceBruteForce();
 
     if (frame >= 0)
       dsda_RestoreBFKeyFrame(frame);
   }
+  else if (bf_engine == dsda_bf_depth_first && frame > 0 && dsda_BFPrune(frame)) {
+    frame = dsda_PruneBFSubtree(frame);
+
+    if (frame >= 0)
+      dsda_RestoreBFKeyFrame(frame);
+    else
+      dsda_FinishBF(dsda_BFExhaustedResult());
+  }
   else
     dsda_StoreBFKeyFrame(frame);
 }
 
-void dsda_EvaluateBruteForce(void) {
-  if (logictic - bf_logictic != bf_depth)
+static void dsda_EvaluateExhaustiveBF(int frame) {
+  if (frame != bf_depth)
+    return;
+
+  bf_index = bf_index_start + bf_volume;
+  ++bf_volume;
+
+  dsda_BFUpdateBestConditionCount();
+
+  if (dsda_BFConditionsReached()) {
+    dsda_CopyBFResult(brute_force, bf_depth);
+    dsda_FinishBF(BF_SUCCESS);
+  }
+  else if (bf_volume >= bf_volume_max)
+    dsda_FinishBF(dsda_BFExhaustedResult());
+}
+
+static void dsda_StartBeamBF(void) {
+  long long level_width;
+  int i;
+
+  dsda_FreeBFBeam();
+
+  bf_beam_width = bf_engine_parameter > 0 ? bf_engine_parameter : DEFAULT_BF_BEAM_WIDTH;
+  bf_beam_size = bf_beam_width;
+  bf_beam[0] = Z_Calloc(bf_beam_size, sizeof(*bf_beam[0]));
+  bf_beam[1] = Z_Calloc(bf_beam_size, sizeof(*bf_beam[1]));
+  bf_beam_current = 0;
+  bf_beam_level = 0;
+  bf_beam_parent = 0;
+
+  bf_volume_max = 0;
+  level_width = 1;
+  for (i = 0; i < bf_depth; ++i) {
+    bf_volume_max += level_width * dsda_BFFrameVolume(i);
+
+    level_width *= dsda_BFFrameVolume(i);
+    if (level_width > bf_beam_width)
+      level_width = bf_beam_width;
+  }
+}
+
+static void dsda_InsertBFBeam(fixed_t score) {
+  bf_beam_entry_t* next;
+  int* count;
+  int slot;
+
+  next = bf_beam[!bf_beam_current];
+  count = &bf_beam_count[!bf_beam_current];
+
+  if (*count < bf_beam_width)
+    slot = (*count)++;
+  else {
+    int i;
+
+    slot = 0;
+    for (i = 1; i < *count; ++i)
+      if (dsda_BFBetterScore(next[slot].score, next[i].score))
+        slot = i;
+
+    if (!dsda_BFBetterScore(score, next[slot].score))
+      return;
+  }
+
+  next[slot].score = score;
+  dsda_GetBFPath(next[slot].path, bf_beam_level + 1);
+  dsda_StoreKeyFrame(&next[slot].key_frame, true, false, thinker_format_compact);
+}
+
+static void dsda_UpdateBeamBF(int frame) {
+  bf_beam_entry_t* beam;
+
+  beam = bf_beam[bf_beam_current];
+
+  if (frame == 0 && !bf_beam_count[bf_beam_current]) {
+    dsda_StoreBFKeyFrame(0);
+    dsda_StoreKeyFrame(&beam[0].key_frame, true, false, thinker_format_compact);
+    bf_beam_count[bf_beam_current] = 1;
+
+    return;
+  }
+
+  if (frame != bf_beam_level + 1)
     return;
 
+  dsda_ReportBFProgress();
+
+  if (!dsda_AdvanceBruteForceFrame(bf_beam_level)) {
+    ++bf_beam_parent;
+
+    if (bf_beam_parent == bf_beam_count[bf_beam_current]) {
+      bf_beam_count[bf_beam_current] = 0;
+      bf_beam_current = !bf_beam_current;
+      bf_beam_parent = 0;
+      ++bf_beam_level;
+
+      if (bf_beam_level == bf_depth || !bf_beam_count[bf_beam_current]) {
+        dsda_FinishBF(dsda_BFExhaustedResult());
+        return;
+      }
+
+      beam = bf_beam[bf_beam_current];
+    }
+  }
+
+  dsda_SetBFPath(beam[bf_beam_parent].path, bf_beam_level);
+  dsda_RestoreKeyFrame(&beam[bf_beam_parent].key_frame, true);
+  bf_tics_saved += bf_beam_level;
+}
+
+static void dsda_EvaluateBeamBF(int frame) {
+  if (frame != bf_beam_level + 1)
+    return;
+
+  bf_index = bf_volume;
+  ++bf_volume;
+
+  if (frame == bf_depth) {
+    dsda_BFUpdateBestConditionCount();
+
+    if (dsda_BFConditionsReached()) {
+      dsda_CopyBFResult(brute_force, bf_depth);
+      dsda_FinishBF(BF_SUCCESS);
+    }
+
+    return;
+  }
+
+  if (dsda_BFPrune(frame)) {
+    ++bf_pruned;
+    return;
+  }
+
+  dsda_InsertBFBeam(dsda_BFScore());
+}
+
+static unsigned int dsda_BFRandom(void) {
+  bf_random_state ^= bf_random_state << 13;
+  bf_random_state ^= bf_random_state >> 17;
+  bf_random_state ^= bf_random_state << 5;
+
+  return bf_random_state;
+}
+
+static int dsda_BFRandomRange(bf_range_t* range) {
+  return range->min + dsda_BFRandom() % dsda_BFRangeVolume(range);
+}
+
+static void dsda_RandomizeBFFrame(bf_command_t* path, int frame) {
+  path[frame].forwardmove = dsda_BFRandomRange(&brute_force[frame].forwardmove);
+  path[frame].sidemove = dsda_BFRandomRange(&brute_force[frame].sidemove);
+  path[frame].angleturn = dsda_BFRandomRange(&brute_force[frame].angleturn);
+}
+
+// Resumes from the deepest key frame shared with the previous run
+static void dsda_RunBFPath(const bf_command_t* path) {
+  int frame;
+
+  for (frame = 0; frame < bf_depth - 1; ++frame)
+    if (memcmp(&path[frame], &bf_run_path[frame], sizeof(*path)))
+      break;
+
+  dsda_SetBFPath(path, bf_depth);
+  memcpy(bf_run_path, path, bf_depth * sizeof(*path));
+
+  dsda_RestoreBFKeyFrame(frame);
+}
+
+static void dsda_StartRandomBF(void) {
+  int i;
+
+  bf_volume_max = bf_engine_parameter > 0 ? bf_engine_parameter : DEFAULT_BF_RANDOM_VOLUME;
+  bf_random_state = 0x9e3779b9;
+  bf_random_valid = false;
+  bf_random_best_valid = false;
+  bf_random_stall = 0;
+  bf_random_restarts = 0;
+
+  for (i = 0; i < bf_depth; ++i)
+    dsda_RandomizeBFFrame(bf_random_path, i);
+
+  dsda_SetBFPath(bf_random_path, bf_depth);
+  memcpy(bf_run_path, bf_random_path, sizeof(bf_run_path));
+}
+
+static void dsda_UpdateRandomBF(int frame) {
+  bf_command_t candidate[MAX_BF_DEPTH];
+  int changes;
+
+  if (frame != bf_depth) {
+    dsda_StoreBFKeyFrame(frame);
+    return;
+  }
+
+  dsda_ReportBFProgress();
+
+  if (bf_random_stall >= 4 * bf_depth && bf_random_best_valid) {
+    // Restart near the best sequence so far, accepting wherever it lands
+    memcpy(candidate, bf_random_best_path, sizeof(candidate));
+    changes = 1 + bf_depth / 4;
+    bf_random_valid = false;
+    bf_random_stall = 0;
+    ++bf_random_restarts;
+  }
+  else {
+    memcpy(candidate, bf_random_path, sizeof(candidate));
+    changes = 1 + dsda_BFRandom() % 2;
+  }
+
+  while (changes--)
+    dsda_RandomizeBFFrame(candidate, dsda_BFRandom() % bf_depth);
+
+  dsda_RunBFPath(candidate);
+}
+
+static void dsda_EvaluateRandomBF(int frame) {
+  dboolean valid;
+  fixed_t score;
+
+  if (frame != bf_depth)
+    return;
+
+  bf_index = bf_volume;
   ++bf_volume;
 
+  dsda_BFUpdateBestConditionCount();
+
   if (dsda_BFConditionsReached()) {
     dsda_CopyBFResult(brute_force, bf_depth);
-    dsda_EndBF(BF_SUCCESS);
+    dsda_FinishBF(BF_SUCCESS);
+    return;
+  }
+
+  if (bf_target.enabled) {
+    valid = dsda_BFConditionCount() == bf_condition_count;
+    score = dsda_BFAttribute(bf_target.attribute);
   }
-  else if (bf_volume >= bf_volume_max) {
-    if (bf_target.enabled && bf_target.evaluated)
-      dsda_EndBF(BF_SUCCESS);
+  else {
+    valid = true;
+    score = dsda_BFConditionCount();
+  }
+
+  if (valid && (!bf_random_valid || !dsda_BFBetterScore(bf_random_score, score))) {
+    if (!bf_random_valid || dsda_BFBetterScore(score, bf_random_score))
+      bf_random_stall = 0;
     else
-      dsda_EndBF(BF_FAILURE);
+      ++bf_random_stall;
+
+    dsda_GetBFPath(bf_random_path, bf_depth);
+    bf_random_score = score;
+    bf_random_valid = true;
+
+    if (!bf_random_best_valid || dsda_BFBetterScore(score, bf_random_best_score)) {
+      memcpy(bf_random_best_path, bf_random_path, sizeof(bf_random_best_path));
+      bf_random_best_score = score;
+      bf_random_best_valid = true;
+    }
+  }
+  else {
+    // Wander until some sequence satisfies the conditions
+    if (!bf_random_valid)
+      dsda_GetBFPath(bf_random_path, bf_depth);
+
+    ++bf_random_stall;
+  }
+
+  if (bf_volume >= bf_volume_max)
+    dsda_FinishBF(dsda_BFExhaustedResult());
+}
+
+dboolean dsda_StartBruteForce(int depth) {
+  int i;
+
+  if (depth <= 0 || depth > MAX_BF_DEPTH)
+    return false;
+
+  dsda_TrackFeature(uf_bruteforce);
+
+  lprintf(LO_INFO, "Brute force starting:\n");
+
+  bf_depth = depth;
+  bf_logictic = logictic;
+  bf_volume = 0;
+  bf_index_start = 0;
+  bf_index = 0;
+  bf_pruned = 0;
+  bf_tics_saved = 0;
+  bf_next_report = BF_REPORT_INTERVAL;
+  bf_best_condition_count = -1;
+
+  for (i = 0; i < bf_depth; ++i)
+    lprintf(LO_INFO, "  %d: F %d:%d S %d:%d T %d:%d B %d\n", i,
+            brute_force[i].forwardmove.min, brute_force[i].forwardmove.max,
+            brute_force[i].sidemove.min, brute_force[i].sidemove.max,
+            brute_force[i].angleturn.min, brute_force[i].angleturn.max,
+            brute_force[i].buttons);
+
+  bf_subtree_volume[bf_depth] = 1;
+  for (i = bf_depth - 1; i >= 0; --i)
+    bf_subtree_volume[i] = bf_subtree_volume[i + 1] * dsda_BFFrameVolume(i);
+
+  bf_volume_max = bf_subtree_volume[0];
+
+  dsda_SetBFIndex(0);
+
+  switch (bf_engine) {
+    case dsda_bf_beam:
+      dsda_StartBeamBF();
+      break;
+    case dsda_bf_random:
+      dsda_StartRandomBF();
+      break;
+    default:
+      break;
+  }
+
+  lprintf(LO_INFO, "Testing %lld sequences with depth %d (%s)\n",
+          bf_volume_max, bf_depth, dsda_bf_engine_names[bf_engine]);
+
+  dsda_FindBFOutsideForces();
+
+  if (bf_outside_force && (bf_engine == dsda_bf_depth_first || bf_engine == dsda_bf_beam))
+    lprintf(LO_INFO, "Reachability pruning is off (%s)\n", bf_outside_force);
+
+  lprintf(LO_INFO, "\n");
+
+  bf_mode = true;
+
+  dsda_EnterSkipMode();
+
+  dsda_StartTimer(dsda_timer_brute_force);
+
+  {
+    int workers;
+
+    workers = dsda_SimpleIntArg(dsda_arg_brute_force_workers);
+
+    if (workers > MAX_BF_WORKERS)
+      workers = MAX_BF_WORKERS;
+
+    if (workers > bf_volume_max)
+      workers = (int) bf_volume_max;
+
+    // Only the ordered engines can be split into independent slices
+    if (bf_engine != dsda_bf_exhaustive && bf_engine != dsda_bf_depth_first)
+      workers = 1;
+
+#ifndef _WIN32
+    if (workers > 1)
+      dsda_RunBFWorkers(workers);
+#endif
+  }
+
+  return true;
+}
+
+void dsda_UpdateBruteForce(void) {
+  int frame;
+
+  frame = logictic - bf_logictic;
+
+  switch (bf_engine) {
+    case dsda_bf_beam:
+      dsda_UpdateBeamBF(frame);
+      break;
+    case dsda_bf_random:
+      dsda_UpdateRandomBF(frame);
+      break;
+    default:
+      dsda_UpdateExhaustiveBF(frame);
+      break;
+  }
+}
+
+void dsda_EvaluateBruteForce(void) {
+  int frame;
+
+  frame = logictic - bf_logictic;
+
+  switch (bf_engine) {
+    case dsda_bf_beam:
+      dsda_EvaluateBeamBF(frame);
+      break;
+    case dsda_bf_random:
+      dsda_EvaluateRandomBF(frame);
+      break;
+    default:
+      dsda_EvaluateExhaustiveBF(frame);
+      break;
   }
 }
 
@@ -58,13 +58,23 @@ typedef enum {
   dsda_bf_limit_max = dsda_bf_limit_duo_max
 } dsda_bf_limit_t;
 
+typedef enum {
+  dsda_bf_exhaustive,
+  dsda_bf_depth_first,
+  dsda_bf_beam,
+  dsda_bf_random,
+  dsda_bf_engine_max,
+} dsda_bf_engine_t;
+
 extern const char* dsda_bf_attribute_names[dsda_bf_attribute_max];
 extern const char* dsda_bf_operator_names[dsda_bf_operator_max];
 extern const char* dsda_bf_limit_names[dsda_bf_limit_max];
+extern const char* dsda_bf_engine_names[dsda_bf_engine_max];
 
 dboolean dsda_BruteForce(void);
 dboolean dsda_BruteForceEnded(void);
 void dsda_ResetBruteForceConditions(void);
+void dsda_SetBruteForceEngine(dsda_bf_engine_t engine, int parameter);
 void dsda_SetBruteForceTarget(dsda_bf_attribute_t attribute,
                               dsda_bf_limit_t limit, fixed_t value);
 void dsda_AddMiscBruteForceCondition(dsda_bf_attribute_t attribute, fixed_t value);
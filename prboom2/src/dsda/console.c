@@ -18,6 +18,7 @@
 #include "d_deh.h"
 #include "doomstat.h"
 #include "g_game.h"
+#include "g_overflow.h"
 #include "hu_lib.h"
 #include "hu_stuff.h"
 #include "i_main.h"
@@ -48,6 +49,7 @@
 #include "dsda/features.h"
 #include "dsda/font.h"
 #include "dsda/global.h"
+#include "dsda/key_frame.h"
 #include "dsda/map_format.h"
 #include "dsda/messenger.h"
 #include "dsda/mobjinfo.h"
@@ -872,6 +874,26 @@ static dboolean console_BruteForceFrame(const char* command, const char* args) {
                                  buttons);
 }
 
+static dboolean console_BruteForceEngine(const char* command, const char* args) {
+  char name[CONSOLE_ENTRY_SIZE];
+  int parameter = 0;
+  int engine;
+
+  if (sscanf(args, "%s %i", name, &parameter) < 1)
+    return false;
+
+  for (engine = 0; engine < dsda_bf_engine_max; ++engine)
+    if (!strcmp(name, dsda_bf_engine_names[engine]))
+      break;
+
+  if (engine == dsda_bf_engine_max)
+    return false;
+
+  dsda_SetBruteForceEngine(engine, parameter);
+
+  return true;
+}
+
 static dboolean console_BruteForceStart(const char* command, const char* args) {
   int depth;
   int forwardmove_min, forwardmove_max;
@@ -994,6 +1016,73 @@ static dboolean console_BruteForceStart(const char* command, const char* args) {
   return dsda_StartBruteForce(depth);
 }
 
+static dboolean console_KeyFrameMemory(const char* command, const char* args) {
+  dsda_ReportKeyFrameMemory();
+
+  return true;
+}
+
+static dboolean console_SightStats(const char* command, const char* args) {
+  dsda_string_t str;
+  int checks;
+
+  checks = sight_cache_hits + sight_cache_misses;
+
+  dsda_StringPrintF(&str, "Sight cache: %d / %d hits (%d%%)\n%d clears",
+                    sight_cache_hits, checks, checks ? sight_cache_hits * 100 / checks : 0,
+                    sight_cache_clears);
+
+  dsda_AddAlert(str.string);
+
+  dsda_FreeString(&str);
+
+  return true;
+}
+
+static dboolean console_SightReset(const char* command, const char* args) {
+  sight_cache_hits = sight_cache_misses = sight_cache_clears = 0;
+
+  return true;
+}
+
+static dboolean console_SectorStats(const char* command, const char* args) {
+  dsda_string_t str;
+
+  dsda_StringPrintF(&str, "Sector checks: %d (%d%% idle)\n%d things, %d rescans skipped",
+                    sector_checks,
+                    sector_checks ? sector_checks_idle * 100 / sector_checks : 0,
+                    sector_things_checked, sector_rescans_skipped);
+
+  dsda_AddAlert(str.string);
+
+  dsda_FreeString(&str);
+
+  return true;
+}
+
+static dboolean console_SectorReset(const char* command, const char* args) {
+  sector_checks = sector_checks_idle = sector_things_checked = sector_rescans_skipped = 0;
+
+  return true;
+}
+
+static dboolean console_LevelPeaks(const char* command, const char* args) {
+  dsda_string_t str;
+
+  dsda_StringPrintF(&str, "Peaks: %d intercepts%s, %d spechits%s\n%d secnodes, %d regrowths",
+                    level_peaks.intercepts,
+                    level_peaks.intercepts > MAXINTERCEPTS_ORIGINAL ? " (overflow)" : "",
+                    level_peaks.spechits,
+                    level_peaks.spechits > MAXSPECIALCROSS_ORIGINAL ? " (overflow)" : "",
+                    level_peaks.secnodes, level_peaks.regrowths);
+
+  dsda_AddAlert(str.string);
+
+  dsda_FreeString(&str);
+
+  return true;
+}
+
 static dboolean console_BuildTurbo(const char* command, const char* args) {
   dsda_ToggleBuildTurbo();
 
@@ -2344,12 +2433,21 @@ static console_command_entry_t console_commands[] = {
   // traversing time
   { "jump.to_tic", console_JumpToTic, CF_DEMO },
   { "jump.by_tic", console_JumpByTic, CF_DEMO },
+  { "key_frame.memory", console_KeyFrameMemory, CF_ALWAYS },
+  { "kf.memory", console_KeyFrameMemory, CF_ALWAYS },
+  { "sight.stats", console_SightStats, CF_ALWAYS },
+  { "sight.reset", console_SightReset, CF_ALWAYS },
+  { "sector.stats", console_SectorStats, CF_ALWAYS },
+  { "sector.reset", console_SectorReset, CF_ALWAYS },
+  { "level.peaks", console_LevelPeaks, CF_ALWAYS },
 
   // build mode
   { "brute_force.start", console_BruteForceStart, CF_DEMO },
   { "bf.start", console_BruteForceStart, CF_DEMO },
   { "brute_force.frame", console_BruteForceFrame, CF_DEMO },
   { "bf.frame", console_BruteForceFrame, CF_DEMO },
+  { "brute_force.engine", console_BruteForceEngine, CF_DEMO },
+  { "bf.engine", console_BruteForceEngine, CF_DEMO },
   { "build.turbo", console_BuildTurbo, CF_DEMO },
   { "b.turbo", console_BuildTurbo, CF_DEMO },
   { "mf", console_BuildMF, CF_DEMO },
@@ -33,7 +33,7 @@ static void dsda_UpdateCurrentComponentText(char* str, size_t max_size) {
 
   snprintf(
     str, max_size,
-    "%sFPS %s%4d %sSEGS %s%4d %sPLANES %s%4d %sSPRITES %s%4d",
+    "%sFPS %s%4d %sSEGS %s%4d %sPLANES %s%4d %sSPRITES %s%4d %sCLIPS %s%5d",
     dsda_TextColor(dsda_tc_exhud_render_label),
     dsda_render_stats_fps < 35 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
                                  dsda_TextColor(dsda_tc_exhud_render_good),
@@ -49,7 +49,11 @@ static void dsda_UpdateCurrentComponentText(char* str, size_t max_size) {
     dsda_TextColor(dsda_tc_exhud_render_label),
     dsda_render_stats.vissprites > 128 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
                                          dsda_TextColor(dsda_tc_exhud_render_good),
-    dsda_render_stats.vissprites
+    dsda_render_stats.vissprites,
+    dsda_TextColor(dsda_tc_exhud_render_label),
+    dsda_render_stats.spriteclips > 4096 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
+                                           dsda_TextColor(dsda_tc_exhud_render_good),
+    dsda_render_stats.spriteclips
   );
 }
 
@@ -58,7 +62,7 @@ static void dsda_UpdateMaxComponentText(char* str, size_t max_size) {
 
   snprintf(
     str, max_size,
-    "%sMAX      SEGS %s%4d %sPLANES %s%4d %sSPRITES %s%4d",
+    "%sMAX      SEGS %s%4d %sPLANES %s%4d %sSPRITES %s%4d %sCLIPS %s%5d",
     dsda_TextColor(dsda_tc_exhud_render_label),
     dsda_render_stats_max.drawsegs > 256 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
                                            dsda_TextColor(dsda_tc_exhud_render_good),
@@ -70,7 +74,11 @@ static void dsda_UpdateMaxComponentText(char* str, size_t max_size) {
     dsda_TextColor(dsda_tc_exhud_render_label),
     dsda_render_stats_max.vissprites > 128 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
                                              dsda_TextColor(dsda_tc_exhud_render_good),
-    dsda_render_stats_max.vissprites
+    dsda_render_stats_max.vissprites,
+    dsda_TextColor(dsda_tc_exhud_render_label),
+    dsda_render_stats_max.spriteclips > 4096 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
+                                               dsda_TextColor(dsda_tc_exhud_render_good),
+    dsda_render_stats_max.spriteclips
   );
 }
 
@@ -41,12 +41,15 @@
 #include "dsda/demo.h"
 #include "dsda/features.h"
 #include "dsda/mapinfo.h"
+#include "dsda/messenger.h"
 #include "dsda/options.h"
 #include "dsda/pause.h"
 #include "dsda/playback.h"
 #include "dsda/save.h"
+#include "dsda/seek_index.h"
 #include "dsda/settings.h"
 #include "dsda/time.h"
+#include "dsda/utility.h"
 
 #include "key_frame.h"
 
@@ -55,17 +58,59 @@ static int auto_kf_timeout_count;
 
 #define TIMEOUT_LIMIT 1
 
+// Auto key frames are stored as xor deltas against the previous frame,
+//   with a full frame at least this often to bound the decode chain
+#define AUTO_KF_FULL_INTERVAL 16
+
+// Matching bytes needed to end a literal run in the delta encoding
+#define DELTA_MIN_MATCH 4
+
+typedef struct {
+  byte* buffer;
+  int length;
+  int size;
+} kf_data_t;
+
 static dsda_key_frame_t first_kf;
 static dsda_key_frame_t quick_kf;
 static dsda_key_frame_t temp_kf;
 static auto_kf_t* auto_key_frames;
 static auto_kf_t* last_auto_kf;
 static int auto_kf_size;
+static int auto_kf_serial;
 static int restore_key_frame_index = -1;
 
+// Decoded contents of the most recently stored or restored auto key frame
+static kf_data_t ref_kf;
+static auto_kf_t* ref_owner;
+static int ref_serial;
+
+static kf_data_t delta_kf;
+
+// A delta buffer freed while detaching frames, reused for the next stored delta
+static kf_data_t spare_delta;
+
+// Full copies of frames that have left the ring, oldest first
+static dsda_key_frame_t* sparse_key_frames;
+static int sparse_kf_count;
+static int sparse_kf_size;
+
+// Frames leaving the ring are kept further apart the older they get
+typedef struct {
+  int age; // seconds, 0 for no limit
+  int spacing; // seconds
+} sparse_kf_tier_t;
+
+static const sparse_kf_tier_t sparse_kf_tiers[] = {
+  { 10 * 60, 10 },
+  { 60 * 60, 60 },
+  { 0, 5 * 60 },
+};
+
 static int dsda_auto_key_frame_interval;
 static int dsda_auto_key_frame_depth;
 static int dsda_auto_key_frame_timeout;
+static int dsda_auto_key_frame_budget;
 
 static int autoKeyFrameTimeout(void) {
   return dsda_StartInBuildMode() ? 0 : dsda_auto_key_frame_timeout;
@@ -89,31 +134,305 @@ static dboolean autoKFExists(auto_kf_t* auto_kf) {
   return auto_kf && auto_kf->auto_index && auto_kf->kf.buffer;
 }
 
-void dsda_ForgetAutoKeyFrames(void) {
-  if (last_auto_kf)
-    last_auto_kf->auto_index = 0;
+static int dsda_SparseKFSpacing(int age) {
+  const sparse_kf_tier_t* tier;
+
+  for (tier = sparse_kf_tiers; tier->age && age >= 35 * tier->age; ++tier);
+
+  return 35 * tier->spacing;
+}
+
+static void dsda_FreeSparseKeyFrames(int first) {
+  int i;
+
+  for (i = first; i < sparse_kf_count; ++i)
+    Z_Free(sparse_key_frames[i].buffer);
+
+  if (first < sparse_kf_count)
+    sparse_kf_count = first;
+}
+
+// Sparse frames after a restored tic belong to a timeline that no longer exists
+static void dsda_TruncateSparseKeyFrames(int tic) {
+  int i;
+
+  for (i = sparse_kf_count; i > 0 && sparse_key_frames[i - 1].game_tic_count > tic; --i);
+
+  dsda_FreeSparseKeyFrames(i);
+}
+
+static dsda_key_frame_t* dsda_LastSparseKeyFrame(int tic) {
+  int i;
+
+  for (i = sparse_kf_count - 1; i >= 0; --i)
+    if (sparse_key_frames[i].game_tic_count <= tic)
+      return &sparse_key_frames[i];
+
+  return NULL;
+}
+
+static void dsda_ThinSparseKeyFrames(void) {
+  int i, kept;
+
+  if (sparse_kf_count < 3)
+    return;
+
+  kept = 1;
+  for (i = 1; i < sparse_kf_count - 1; ++i) {
+    dsda_key_frame_t* key_frame;
+
+    key_frame = &sparse_key_frames[i];
+
+    // Drop a frame when its neighbours are close enough together for its age
+    if (sparse_key_frames[i + 1].game_tic_count - sparse_key_frames[kept - 1].game_tic_count <=
+        dsda_SparseKFSpacing(logictic - key_frame->game_tic_count)) {
+      Z_Free(key_frame->buffer);
+      continue;
+    }
+
+    sparse_key_frames[kept++] = *key_frame;
+  }
+
+  sparse_key_frames[kept++] = sparse_key_frames[sparse_kf_count - 1];
+  sparse_kf_count = kept;
+}
+
+static void dsda_ReserveKFData(kf_data_t* data, int size) {
+  if (size <= data->size)
+    return;
+
+  if (size < data->size * 2)
+    size = data->size * 2;
+
+  data->buffer = Z_Realloc(data->buffer, size);
+  data->size = size;
+}
+
+// Bytes past the old length are zeroed so that deltas can xor over them
+static void dsda_ResizeKFData(kf_data_t* data, int length) {
+  dsda_ReserveKFData(data, length);
+
+  if (length > data->length)
+    memset(data->buffer + data->length, 0, length - data->length);
+
+  data->length = length;
+}
+
+static void dsda_CopyKFData(kf_data_t* data, const byte* buffer, int length) {
+  dsda_ReserveKFData(data, length);
+  memcpy(data->buffer, buffer, length);
+  data->length = length;
+}
+
+static void dsda_WriteDeltaCount(int count) {
+  dsda_ReserveKFData(&delta_kf, delta_kf.length + 5);
+
+  while (count >= 0x80) {
+    delta_kf.buffer[delta_kf.length++] = (count & 0x7f) | 0x80;
+    count >>= 7;
+  }
+
+  delta_kf.buffer[delta_kf.length++] = count;
+}
+
+static const byte* dsda_ReadDeltaCount(const byte* p, int* count) {
+  int shift = 0;
+
+  *count = 0;
+
+  do {
+    *count |= (*p & 0x7f) << shift;
+    shift += 7;
+  } while (*p++ & 0x80);
+
+  return p;
+}
+
+#define DELTA_BYTE(i) ((i) < length ? buffer[i] ^ ref_kf.buffer[i] : ref_kf.buffer[i])
+
+// Encodes buffer ^ ref_kf into delta_kf as (skip, count, xor bytes) runs
+static void dsda_EncodeDelta(const byte* buffer, int length) {
+  int i, max_length;
+
+  max_length = MAX(length, ref_kf.length);
+  dsda_ResizeKFData(&ref_kf, max_length);
+  delta_kf.length = 0;
+
+  i = 0;
+  while (i < max_length) {
+    int skip_start, literal_start, match;
+
+    skip_start = i;
+    while (i < max_length) {
+      if (i + 8 <= length && !memcmp(buffer + i, ref_kf.buffer + i, 8))
+        i += 8;
+      else if (!DELTA_BYTE(i))
+        ++i;
+      else
+        break;
+    }
+
+    if (i == max_length)
+      break;
+
+    literal_start = i;
+    match = 0;
+    while (i < max_length && match < DELTA_MIN_MATCH) {
+      if (DELTA_BYTE(i))
+        match = 0;
+      else
+        ++match;
+
+      ++i;
+    }
+    i -= match;
+
+    dsda_WriteDeltaCount(literal_start - skip_start);
+    dsda_WriteDeltaCount(i - literal_start);
+
+    dsda_ReserveKFData(&delta_kf, delta_kf.length + i - literal_start);
+    for (; literal_start < i; ++literal_start)
+      delta_kf.buffer[delta_kf.length++] = DELTA_BYTE(literal_start);
+  }
+}
+
+#undef DELTA_BYTE
+
+// The data must already span both lengths involved in the delta
+static void dsda_ApplyDelta(kf_data_t* data, const byte* delta, int delta_length) {
+  const byte* end;
+  byte* dest;
+
+  end = delta + delta_length;
+  dest = data->buffer;
+
+  while (delta < end) {
+    int skip, count;
+
+    delta = dsda_ReadDeltaCount(delta, &skip);
+    delta = dsda_ReadDeltaCount(delta, &count);
+
+    dest += skip;
+    while (count--)
+      *dest++ ^= *delta++;
+  }
+}
+
+static void dsda_ForwardDelta(kf_data_t* data, auto_kf_t* auto_kf) {
+  dsda_ResizeKFData(data, MAX(auto_kf->base_length, auto_kf->length));
+  dsda_ApplyDelta(data, auto_kf->kf.buffer, auto_kf->kf.buffer_length);
+  data->length = auto_kf->length;
+}
+
+static void dsda_BackwardDelta(kf_data_t* data, auto_kf_t* auto_kf) {
+  dsda_ResizeKFData(data, MAX(auto_kf->base_length, auto_kf->length));
+  dsda_ApplyDelta(data, auto_kf->kf.buffer, auto_kf->kf.buffer_length);
+  data->length = auto_kf->base_length;
+}
+
+static dboolean dsda_DeltaBase(auto_kf_t* auto_kf) {
+  return auto_kf->delta && auto_kf->prev->kf.buffer &&
+         auto_kf->prev->serial == auto_kf->base_serial;
+}
+
+static dboolean dsda_RefOwnerValid(void) {
+  return ref_owner && ref_owner->kf.buffer && ref_owner->serial == ref_serial;
+}
+
+static void dsda_SetRefOwner(auto_kf_t* auto_kf) {
+  ref_owner = auto_kf;
+  ref_serial = auto_kf ? auto_kf->serial : 0;
+}
+
+// Reconstructs the full contents of an auto key frame in ref_kf
+static dboolean dsda_DecodeAutoKF(auto_kf_t* target) {
+  auto_kf_t* chain[AUTO_KF_FULL_INTERVAL];
+  auto_kf_t* start;
+  auto_kf_t* auto_kf;
+  dboolean ref_valid;
+  int forward_steps;
+  int backward_steps;
+
+  ref_valid = dsda_RefOwnerValid();
+
+  if (ref_valid && ref_owner == target)
+    return true;
+
+  // Deltas between the closest earlier full or reference frame and the target
+  forward_steps = 0;
+  for (start = target; start->delta && !(ref_valid && start == ref_owner); start = start->prev) {
+    if (forward_steps == AUTO_KF_FULL_INTERVAL || !dsda_DeltaBase(start)) {
+      forward_steps = -1;
+      break;
+    }
+
+    chain[forward_steps++] = start;
+  }
+
+  // Deltas between the reference frame and an earlier target
+  backward_steps = -1;
+  if (ref_valid) {
+    int steps = 0;
+
+    for (auto_kf = ref_owner; steps < auto_kf_size && dsda_DeltaBase(auto_kf); auto_kf = auto_kf->prev) {
+      ++steps;
+
+      if (auto_kf->prev == target) {
+        backward_steps = steps;
+        break;
+      }
+    }
+  }
+
+  if (backward_steps >= 0 && (forward_steps < 0 || backward_steps < forward_steps)) {
+    for (auto_kf = ref_owner; auto_kf != target; auto_kf = auto_kf->prev)
+      dsda_BackwardDelta(&ref_kf, auto_kf);
+  }
+  else if (forward_steps >= 0) {
+    if (!ref_valid || start != ref_owner)
+      dsda_CopyKFData(&ref_kf, start->kf.buffer, start->length);
+
+    while (forward_steps)
+      dsda_ForwardDelta(&ref_kf, chain[--forward_steps]);
+  }
+  else
+    return false;
+
+  dsda_SetRefOwner(target);
+
+  return true;
 }
 
 static void dsda_ResetParentKF(dsda_key_frame_t* kf) {
   kf->parent.auto_kf = NULL;
-  kf->parent.buffer = NULL;
+  kf->parent.serial = 0;
 }
 
 static void dsda_AttachAutoKF(dsda_key_frame_t* kf) {
   if (autoKFExists(last_auto_kf)) {
     kf->parent.auto_kf = last_auto_kf;
-    kf->parent.buffer = last_auto_kf->kf.buffer;
+    kf->parent.serial = last_auto_kf->serial;
   }
   else
     dsda_ResetParentKF(kf);
 }
 
+static void dsda_BreakAutoKFChain(void) {
+  if (last_auto_kf)
+    last_auto_kf->auto_index = 0;
+}
+
+void dsda_ForgetAutoKeyFrames(void) {
+  dsda_BreakAutoKFChain();
+  dsda_FreeSparseKeyFrames(0);
+}
+
 static void dsda_ResolveParentKF(dsda_key_frame_t* kf) {
-  if (autoKFExists(kf->parent.auto_kf) && kf->parent.auto_kf->kf.buffer == kf->parent.buffer)
+  if (autoKFExists(kf->parent.auto_kf) && kf->parent.auto_kf->serial == kf->parent.serial)
     last_auto_kf = kf->parent.auto_kf;
   else {
     dsda_ResetParentKF(kf);
-    dsda_ForgetAutoKeyFrames();
+    dsda_BreakAutoKFChain();
   }
 }
 
@@ -130,8 +449,11 @@ static void dsda_RewindKF(auto_kf_t** current) {
     *current = NULL;
 }
 
-static dsda_key_frame_t* dsda_ClosestKeyFrame(int target_tic_count) {
+static dsda_key_frame_t* dsda_ClosestKeyFrame(int target_tic_count, auto_kf_t** closest_auto_kf) {
   dsda_key_frame_t* closest = NULL;
+  dsda_key_frame_t* sparse_kf;
+
+  *closest_auto_kf = NULL;
 
   if (last_auto_kf) {
     auto_kf_t* auto_kf;
@@ -141,10 +463,16 @@ static dsda_key_frame_t* dsda_ClosestKeyFrame(int target_tic_count) {
       if (auto_kf->kf.game_tic_count <= target_tic_count)
         if (!closest || auto_kf->kf.game_tic_count > closest->game_tic_count) {
           closest = &auto_kf->kf;
+          *closest_auto_kf = auto_kf;
           break;
         }
   }
 
+  sparse_kf = dsda_LastSparseKeyFrame(target_tic_count);
+  if (sparse_kf)
+    if (!closest || sparse_kf->game_tic_count > closest->game_tic_count)
+      closest = sparse_kf;
+
   if (!demorecording && temp_kf.buffer)
     if (temp_kf.game_tic_count <= target_tic_count)
       if (!closest || temp_kf.game_tic_count > closest->game_tic_count)
@@ -160,12 +488,16 @@ static dsda_key_frame_t* dsda_ClosestKeyFrame(int target_tic_count) {
       if (!closest || first_kf.game_tic_count > closest->game_tic_count)
         closest = &first_kf;
 
+  if (*closest_auto_kf && closest != &(*closest_auto_kf)->kf)
+    *closest_auto_kf = NULL;
+
   return closest;
 }
 
 void dsda_CopyKeyFrame(dsda_key_frame_t* dest, dsda_key_frame_t* source) {
   *dest = *source;
   dest->buffer = Z_Malloc(dest->buffer_length);
+  dest->buffer_size = dest->buffer_length;
   memcpy(dest->buffer, source->buffer, dest->buffer_length);
 }
 
@@ -175,6 +507,23 @@ void dsda_InitKeyFrame(void) {
   dsda_auto_key_frame_interval = dsda_IntConfig(dsda_config_auto_key_frame_interval);
   dsda_auto_key_frame_depth = dsda_IntConfig(dsda_config_auto_key_frame_depth);
   dsda_auto_key_frame_timeout = dsda_IntConfig(dsda_config_auto_key_frame_timeout);
+  dsda_auto_key_frame_budget = dsda_IntConfig(dsda_config_auto_key_frame_budget);
+
+  dsda_FreeSparseKeyFrames(0);
+
+  if (auto_key_frames != NULL) {
+    for (i = 0; i < auto_kf_size; ++i)
+      if (auto_key_frames[i].kf.buffer)
+        Z_Free(auto_key_frames[i].kf.buffer);
+
+    Z_Free(auto_key_frames);
+  }
+
+  auto_key_frames = NULL;
+  dsda_SetRefOwner(NULL);
+  dsda_ResetParentKF(&first_kf);
+  dsda_ResetParentKF(&quick_kf);
+  dsda_ResetParentKF(&temp_kf);
 
   auto_kf_size = autoKeyFrameDepth();
 
@@ -183,9 +532,6 @@ void dsda_InitKeyFrame(void) {
     return;
   }
 
-  if (auto_key_frames != NULL)
-    Z_Free(auto_key_frames);
-
   ++auto_kf_size; // chain includes a terminator
 
   auto_key_frames = Z_Calloc(auto_kf_size, sizeof(auto_kf_t));
@@ -218,9 +564,17 @@ void dsda_ExportKeyFrame(byte* buffer, int length) {
 }
 
 // Stripped down version of G_DoSaveGame
-void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export) {
+// Frames that other builds may read should use thinker_format_struct
+void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export,
+                        thinker_format_t format) {
   key_frame->game_tic_count = logictic;
 
+  // The old buffer is likely the right size for this one
+  if (key_frame->buffer != NULL) {
+    P_ReleaseSaveBuffer(key_frame->buffer, MAX(key_frame->buffer_size, key_frame->buffer_length));
+    key_frame->buffer = NULL;
+  }
+
   P_InitSaveBuffer();
 
   P_SAVE_BYTE(complete);
@@ -232,12 +586,13 @@ void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export)
   // Store state of demo recording buffer
   dsda_StoreDemoData(complete);
 
+  thinker_archive_format = format;
   dsda_ArchiveAll();
-
-  if (key_frame->buffer != NULL) Z_Free(key_frame->buffer);
+  thinker_archive_format = thinker_format_struct;
 
   key_frame->buffer = savebuffer;
   key_frame->buffer_length = save_p - savebuffer;
+  key_frame->buffer_size = P_SaveBufferSize();
 
   P_ForgetSaveBuffer();
 
@@ -290,15 +645,34 @@ void dsda_RestoreKeyFrame(dsda_key_frame_t* key_frame, dboolean skip_wipe) {
 
   dsda_ResolveParentKF(key_frame);
 
+  dsda_TruncateSparseKeyFrames(key_frame->game_tic_count);
+
   doom_printf("Restored key frame");
 }
 
+static dboolean dsda_RestoreAutoKeyFrame(auto_kf_t* auto_kf, dboolean skip_wipe) {
+  dsda_key_frame_t key_frame;
+
+  if (!dsda_DecodeAutoKF(auto_kf)) {
+    doom_printf("No key frame found");
+    return false;
+  }
+
+  key_frame = auto_kf->kf;
+  key_frame.buffer = ref_kf.buffer;
+  key_frame.buffer_length = ref_kf.length;
+
+  dsda_RestoreKeyFrame(&key_frame, skip_wipe);
+
+  return true;
+}
+
 void dsda_StoreTempKeyFrame(void) {
-  dsda_StoreKeyFrame(&temp_kf, true, true);
+  dsda_StoreKeyFrame(&temp_kf, true, true, thinker_format_struct);
 }
 
 void dsda_StoreQuickKeyFrame(void) {
-  dsda_StoreKeyFrame(&quick_kf, true, true);
+  dsda_StoreKeyFrame(&quick_kf, true, true, thinker_format_struct);
 }
 
 void dsda_RestoreQuickKeyFrame(void) {
@@ -307,12 +681,19 @@ void dsda_RestoreQuickKeyFrame(void) {
 
 dboolean dsda_RestoreClosestKeyFrame(int tic) {
   dsda_key_frame_t* key_frame;
+  auto_kf_t* auto_kf;
+
+  key_frame = dsda_ClosestKeyFrame(tic, &auto_kf);
 
-  key_frame = dsda_ClosestKeyFrame(tic);
+  if (dsda_RestoreSeekIndex(tic, key_frame ? key_frame->game_tic_count : -1))
+    return true;
 
   if (!key_frame)
     return false;
 
+  if (auto_kf)
+    return dsda_RestoreAutoKeyFrame(auto_kf, true);
+
   dsda_RestoreKeyFrame(key_frame, true);
 
   return true;
@@ -346,9 +727,271 @@ void dsda_RewindAutoKeyFrame(void) {
   dsda_RewindKF(&load_kf);
 
   if (load_kf)
-    dsda_RestoreKeyFrame(&load_kf->kf, true);
-  else
-    doom_printf("No key frame found"); // rewind past the depth limit
+    dsda_RestoreAutoKeyFrame(load_kf, true);
+  else {
+    dsda_key_frame_t* sparse_kf;
+
+    // Past the ring, fall back to the sparse frames
+    sparse_kf = dsda_LastSparseKeyFrame(
+      (autoKFExists(last_auto_kf) ? last_auto_kf->kf.game_tic_count : logictic) - 1
+    );
+
+    if (sparse_kf)
+      dsda_RestoreKeyFrame(sparse_kf, true);
+    else
+      doom_printf("No key frame found"); // rewind past the depth limit
+  }
+}
+
+static void dsda_KeepSpareDelta(byte* buffer, int size) {
+  if (size <= spare_delta.size) {
+    Z_Free(buffer);
+    return;
+  }
+
+  if (spare_delta.buffer)
+    Z_Free(spare_delta.buffer);
+
+  spare_delta.buffer = buffer;
+  spare_delta.length = 0;
+  spare_delta.size = size;
+}
+
+// Turns the next frame into a full frame if it depends on this one
+static void dsda_DetachAutoKF(auto_kf_t* auto_kf) {
+  auto_kf_t* next;
+  kf_data_t data;
+
+  next = auto_kf->next;
+
+  if (!next->kf.buffer || !dsda_DeltaBase(next))
+    return;
+
+  if (!auto_kf->delta) {
+    // The overwritten frame's buffer already holds the base contents
+    data.buffer = auto_kf->kf.buffer;
+    data.length = auto_kf->length;
+    data.size = MAX(auto_kf->kf.buffer_size, auto_kf->length);
+    auto_kf->kf.buffer = NULL;
+
+    dsda_ForwardDelta(&data, next);
+  }
+  else {
+    if (!dsda_DecodeAutoKF(next))
+      return;
+
+    data.buffer = Z_Malloc(ref_kf.length);
+    data.length = ref_kf.length;
+    data.size = ref_kf.length;
+    memcpy(data.buffer, ref_kf.buffer, data.length);
+  }
+
+  dsda_KeepSpareDelta(next->kf.buffer, MAX(next->kf.buffer_size, next->kf.buffer_length));
+  next->kf.buffer = data.buffer;
+  next->kf.buffer_length = data.length;
+  next->kf.buffer_size = data.size;
+  next->delta = false;
+  next->full_distance = 0;
+}
+
+static void dsda_StoreAutoKeyFrame(auto_kf_t* auto_kf) {
+  auto_kf_t* base;
+  dboolean delta;
+
+  dsda_DetachAutoKF(auto_kf);
+
+  // Full buffers go back to the save buffer pool, but a delta buffer can hold the next delta
+  if (auto_kf->delta && auto_kf->kf.buffer) {
+    dsda_KeepSpareDelta(auto_kf->kf.buffer, MAX(auto_kf->kf.buffer_size, auto_kf->kf.buffer_length));
+    auto_kf->kf.buffer = NULL;
+  }
+
+  base = auto_kf->prev;
+  delta = dsda_RefOwnerValid() && ref_owner == base &&
+          base->full_distance + 1 < AUTO_KF_FULL_INTERVAL;
+
+  auto_kf->serial = ++auto_kf_serial;
+
+  // Ring frames are stored as deltas of each other, which needs fixed positions
+  dsda_StoreKeyFrame(&auto_kf->kf, false, false, thinker_format_packed);
+
+  auto_kf->length = auto_kf->kf.buffer_length;
+
+  if (delta) {
+    auto_kf->delta = true;
+    auto_kf->base_serial = base->serial;
+    auto_kf->base_length = ref_kf.length;
+    auto_kf->full_distance = base->full_distance + 1;
+
+    dsda_EncodeDelta(auto_kf->kf.buffer, auto_kf->length);
+
+    // The serialized frame becomes the reference for the next delta
+    P_ReleaseSaveBuffer(ref_kf.buffer, ref_kf.size);
+    ref_kf.buffer = auto_kf->kf.buffer;
+    ref_kf.length = auto_kf->length;
+    ref_kf.size = auto_kf->kf.buffer_size;
+
+    dsda_ReserveKFData(&spare_delta, MAX(delta_kf.length, 1));
+    auto_kf->kf.buffer = spare_delta.buffer;
+    auto_kf->kf.buffer_length = delta_kf.length;
+    auto_kf->kf.buffer_size = spare_delta.size;
+    memcpy(auto_kf->kf.buffer, delta_kf.buffer, delta_kf.length);
+    memset(&spare_delta, 0, sizeof(spare_delta));
+  }
+  else {
+    auto_kf->delta = false;
+    auto_kf->full_distance = 0;
+
+    dsda_CopyKFData(&ref_kf, auto_kf->kf.buffer, auto_kf->length);
+  }
+
+  dsda_SetRefOwner(auto_kf);
+}
+
+// Keeps a full copy of a frame leaving the ring if it is far enough from the last one kept
+static void dsda_PromoteAutoKF(auto_kf_t* auto_kf) {
+  kf_data_t saved_ref;
+  auto_kf_t* saved_owner;
+  int saved_serial;
+  int tic;
+
+  if (!autoKFExists(auto_kf))
+    return;
+
+  tic = auto_kf->kf.game_tic_count;
+
+  // Frames after a rewind point are overwritten, not retired
+  if (tic >= logictic)
+    return;
+
+  if (sparse_kf_count) {
+    int last_tic;
+
+    last_tic = sparse_key_frames[sparse_kf_count - 1].game_tic_count;
+
+    if (tic <= last_tic || tic - last_tic < dsda_SparseKFSpacing(logictic - tic))
+      return;
+  }
+
+  // Decode into a fresh buffer so the reference for the next delta survives
+  saved_ref = ref_kf;
+  saved_owner = ref_owner;
+  saved_serial = ref_serial;
+  memset(&ref_kf, 0, sizeof(ref_kf));
+  dsda_SetRefOwner(NULL);
+
+  if (dsda_DecodeAutoKF(auto_kf)) {
+    dsda_key_frame_t* sparse_kf;
+
+    if (sparse_kf_count == sparse_kf_size) {
+      sparse_kf_size = sparse_kf_size ? sparse_kf_size * 2 : 64;
+      sparse_key_frames = Z_Realloc(sparse_key_frames, sparse_kf_size * sizeof(*sparse_key_frames));
+    }
+
+    sparse_kf = &sparse_key_frames[sparse_kf_count++];
+    *sparse_kf = auto_kf->kf;
+    sparse_kf->buffer = Z_Realloc(ref_kf.buffer, ref_kf.length);
+    sparse_kf->buffer_length = ref_kf.length;
+    sparse_kf->buffer_size = ref_kf.length;
+    dsda_ResetParentKF(sparse_kf);
+  }
+  else if (ref_kf.buffer)
+    Z_Free(ref_kf.buffer);
+
+  ref_kf = saved_ref;
+  ref_owner = saved_owner;
+  ref_serial = saved_serial;
+}
+
+// Counts allocated sizes, including the slack P_InitSaveBuffer leaves and
+//   the buffers parked in the save buffer pool
+static void dsda_CountAutoKFBytes(size_t* dense, size_t* sparse, size_t* scratch) {
+  int i;
+
+  *dense = 0;
+  for (i = 0; i < auto_kf_size; ++i)
+    if (auto_key_frames[i].kf.buffer)
+      *dense += MAX(auto_key_frames[i].kf.buffer_size, auto_key_frames[i].kf.buffer_length);
+
+  *sparse = 0;
+  for (i = 0; i < sparse_kf_count; ++i)
+    *sparse += MAX(sparse_key_frames[i].buffer_size, sparse_key_frames[i].buffer_length);
+
+  *scratch = ref_kf.size + delta_kf.size + spare_delta.size + P_SaveBufferPoolSize();
+}
+
+static size_t dsda_AutoKFBytes(void) {
+  size_t dense, sparse, scratch;
+
+  dsda_CountAutoKFBytes(&dense, &sparse, &scratch);
+
+  return dense + sparse + scratch;
+}
+
+// Drops the oldest sparse frames, then the oldest frames in the ring
+static void dsda_EnforceAutoKFBudget(void) {
+  size_t budget;
+
+  if (!dsda_auto_key_frame_budget)
+    return;
+
+  budget = (size_t) dsda_auto_key_frame_budget * 1024 * 1024;
+
+  while (dsda_AutoKFBytes() > budget) {
+    auto_kf_t* oldest;
+    auto_kf_t* auto_kf;
+
+    if (sparse_kf_count) {
+      Z_Free(sparse_key_frames[0].buffer);
+      memmove(sparse_key_frames, sparse_key_frames + 1,
+              (sparse_kf_count - 1) * sizeof(*sparse_key_frames));
+      --sparse_kf_count;
+      continue;
+    }
+
+    oldest = last_auto_kf;
+    for (auto_kf = last_auto_kf; autoKFExists(auto_kf); dsda_RewindKF(&auto_kf))
+      oldest = auto_kf;
+
+    if (oldest == last_auto_kf)
+      break;
+
+    dsda_DetachAutoKF(oldest);
+
+    if (oldest->kf.buffer) {
+      Z_Free(oldest->kf.buffer);
+      oldest->kf.buffer = NULL;
+    }
+
+    oldest->auto_index = 0;
+  }
+}
+
+void dsda_ReportKeyFrameMemory(void) {
+  dsda_string_t str;
+  size_t dense, sparse, scratch;
+  int count;
+  auto_kf_t* auto_kf;
+
+  count = 0;
+  for (auto_kf = last_auto_kf; autoKFExists(auto_kf); dsda_RewindKF(&auto_kf))
+    ++count;
+
+  dsda_CountAutoKFBytes(&dense, &sparse, &scratch);
+
+  dsda_StringPrintF(&str, "Key frames: %.1f MB",
+                    (float) (dense + sparse + scratch) / (1024 * 1024));
+
+  if (dsda_auto_key_frame_budget)
+    dsda_StringCatF(&str, " / %d MB", dsda_auto_key_frame_budget);
+
+  dsda_StringCatF(&str, "\n%d recent: %.1f MB\n%d sparse: %.1f MB",
+                  count, (float) dense / (1024 * 1024),
+                  sparse_kf_count, (float) sparse / (1024 * 1024));
+
+  dsda_AddAlert(str.string);
+
+  dsda_FreeString(&str);
 }
 
 void dsda_ResetAutoKeyFrameTimeout(void) {
@@ -383,6 +1026,7 @@ void dsda_UpdateAutoKeyFrames(void) {
     }
 
     last_auto_kf = last_auto_kf->next;
+    dsda_PromoteAutoKF(last_auto_kf->next);
     last_auto_kf->next->auto_index = 0;
     last_auto_kf->auto_index = last_auto_kf->prev->auto_index + 1;
 
@@ -392,7 +1036,7 @@ void dsda_UpdateAutoKeyFrames(void) {
       unsigned long long elapsed_time;
 
       dsda_StartTimer(dsda_timer_key_frame);
-      dsda_StoreKeyFrame(current_key_frame, false, false);
+      dsda_StoreAutoKeyFrame(last_auto_kf);
       elapsed_time = dsda_ElapsedTimeMS(dsda_timer_key_frame);
 
       if (autoKeyFrameTimeout()) {
@@ -409,7 +1053,17 @@ void dsda_UpdateAutoKeyFrames(void) {
       }
     }
 
-    if (!first_kf.buffer)
-      dsda_CopyKeyFrame(&first_kf, current_key_frame);
+    if (!first_kf.buffer) {
+      dsda_key_frame_t full_key_frame;
+
+      full_key_frame = *current_key_frame;
+      full_key_frame.buffer = ref_kf.buffer;
+      full_key_frame.buffer_length = ref_kf.length;
+
+      dsda_CopyKeyFrame(&first_kf, &full_key_frame);
+    }
+
+    dsda_ThinSparseKeyFrames();
+    dsda_EnforceAutoKFBudget();
   }
 }
@@ -19,29 +19,38 @@
 #define __DSDA_KEY_FRAME__
 
 #include "doomtype.h"
+#include "p_saveg.h"
 
 struct auto_kf_s;
 
 typedef struct {
-  byte* buffer;
+  int serial;
   struct auto_kf_s* auto_kf;
 } parent_kf_t;
 
 typedef struct {
   byte* buffer;
   int buffer_length;
+  int buffer_size; // allocated size, if known
   int game_tic_count;
   parent_kf_t parent;
 } dsda_key_frame_t;
 
 typedef struct auto_kf_s {
   int auto_index;
+  int serial;
   dsda_key_frame_t kf;
+  dboolean delta; // kf.buffer holds an xor delta against the frame in prev
+  int base_serial;
+  int base_length;
+  int length;
+  int full_distance;
   struct auto_kf_s* prev;
   struct auto_kf_s* next;
 } auto_kf_t;
 
-void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export);
+void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export,
+                        thinker_format_t format);
 void dsda_RestoreKeyFrame(dsda_key_frame_t* key_frame, dboolean skip_wipe);
 void dsda_InitKeyFrame(void);
 void dsda_ContinueKeyFrame(void);
@@ -54,5 +63,6 @@ void dsda_RewindAutoKeyFrame(void);
 void dsda_ResetAutoKeyFrameTimeout(void);
 void dsda_UpdateAutoKeyFrames(void);
 void dsda_ForgetAutoKeyFrames(void);
+void dsda_ReportKeyFrameMemory(void);
 
 #endif
@@ -15,6 +15,8 @@
 //	DSDA Playback
 //
 
+#include <stdint.h>
+
 #include "doomstat.h"
 #include "g_game.h"
 #include "i_system.h"
@@ -26,6 +28,7 @@
 #include "dsda/exdemo.h"
 #include "dsda/input.h"
 #include "dsda/key_frame.h"
+#include "dsda/seek_index.h"
 #include "dsda/skip.h"
 
 #include "playback.h"
@@ -54,8 +57,12 @@ dboolean dsda_JumpToLogicTic(int tic) {
   if (tic < 0)
     return false;
 
-  if (tic > logictic)
-    dsda_SkipToLogicTic(tic);
+  if (tic > logictic) {
+    dsda_RestoreSeekIndex(tic, logictic);
+
+    if (tic != logictic)
+      dsda_SkipToLogicTic(tic);
+  }
   else if (tic < logictic) {
     if (!dsda_RestoreClosestKeyFrame(tic))
       return false;
@@ -170,14 +177,23 @@ int dsda_PlaybackTics(void) {
   return playback_tics;
 }
 
+// The position is stored as an offset so key frames survive a restart
 void dsda_StorePlaybackPosition(void) {
+  intptr_t offset;
+
+  offset = playback_origin_p ? playback_p - playback_origin_p : -1;
+
   P_SAVE_X(playback_tics);
-  P_SAVE_X(playback_p);
+  P_SAVE_X(offset);
 }
 
 void dsda_RestorePlaybackPosition(void) {
+  intptr_t offset;
+
   P_LOAD_X(playback_tics);
-  P_LOAD_X(playback_p);
+  P_LOAD_X(offset);
+
+  playback_p = playback_origin_p && offset >= 0 ? playback_origin_p + offset : NULL;
 }
 
 void dsda_ClearPlaybackStream(void) {
@@ -189,6 +205,8 @@ void dsda_ClearPlaybackStream(void) {
 
   demoplayback = false;
   userdemo = false;
+
+  dsda_CloseSeekIndex();
 }
 
 static dboolean dsda_EndOfPlaybackStream(void) {
@@ -37,6 +37,9 @@ static void dsda_UpdateMaxValues(dsda_render_stats_t* x, dsda_render_stats_t* y)
 
   if (x->vissprites < y->vissprites)
     x->vissprites = y->vissprites;
+
+  if (x->spriteclips < y->spriteclips)
+    x->spriteclips = y->spriteclips;
 }
 
 void dsda_BeginRenderStats(void) {
@@ -72,6 +75,11 @@ void dsda_RecordDrawSegs(int n) {
   frame_stats.drawsegs += n;
 }
 
+// Drawsegs checked against sprites
+void dsda_RecordSpriteClips(int n) {
+  frame_stats.spriteclips += n;
+}
+
 void dsda_UpdateRenderStats(void) {
   dsda_UpdateMaxValues(&interval_stats, &frame_stats);
 
@@ -22,6 +22,7 @@ typedef struct {
   int visplanes;
   int drawsegs;
   int vissprites;
+  int spriteclips;
 } dsda_render_stats_t;
 
 void dsda_BeginRenderStats(void);
@@ -31,6 +32,7 @@ void dsda_RecordVisPlane(void);
 void dsda_RecordVisPlanes(int n);
 void dsda_RecordDrawSeg(void);
 void dsda_RecordDrawSegs(int n);
+void dsda_RecordSpriteClips(int n);
 void dsda_UpdateRenderStats(void);
 
 #endif
@@ -0,0 +1,293 @@
+//
+// Copyright(C) 2026 by the dsda-doom contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Seek Index
+//
+//	Key frames sampled during playback are appended to a file in the data
+//	directory, named after the demo checksum, so later playbacks can jump
+//	close to any tic without simulating everything before it.
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "e6y.h"
+#include "g_game.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "md5.h"
+#include "w_wad.h"
+#include "z_zone.h"
+
+#include "dsda/args.h"
+#include "dsda/data_organizer.h"
+#include "dsda/key_frame.h"
+#include "dsda/utility.h"
+
+#include "seek_index.h"
+
+#define DSDA_SEEK_INDEX_VERSION 1
+#define SEEK_INDEX_ENGINE_LENGTH 32
+
+typedef struct {
+  int version;
+  int interval;
+  char engine[SEEK_INDEX_ENGINE_LENGTH];
+} seek_index_header_t;
+
+typedef struct {
+  int tic;
+  int length;
+  long offset;
+} seek_entry_t;
+
+static FILE* seek_index_file;
+static seek_entry_t* seek_entries;
+static int seek_entry_count;
+static int seek_entry_size;
+static int seek_interval;
+static dboolean seek_index_writable;
+static dsda_key_frame_t seek_key_frame;
+
+static void dsda_InitSeekIndexHeader(seek_index_header_t* header) {
+  memset(header, 0, sizeof(*header));
+  header->version = DSDA_SEEK_INDEX_VERSION;
+  header->interval = seek_interval;
+  strncpy(header->engine, PACKAGE_VERSION, SEEK_INDEX_ENGINE_LENGTH - 1);
+}
+
+static void dsda_AddSeekEntry(int tic, int length, long offset) {
+  if (seek_entry_count == seek_entry_size) {
+    seek_entry_size = seek_entry_size ? seek_entry_size * 2 : 256;
+    seek_entries = Z_Realloc(seek_entries, seek_entry_size * sizeof(*seek_entries));
+  }
+
+  seek_entries[seek_entry_count].tic = tic;
+  seek_entries[seek_entry_count].length = length;
+  seek_entries[seek_entry_count].offset = offset;
+  ++seek_entry_count;
+}
+
+// Returns false if the file doesn't match this engine and demo setup
+static dboolean dsda_ReadSeekIndex(void) {
+  seek_index_header_t expected, header;
+
+  dsda_InitSeekIndexHeader(&expected);
+
+  if (fread(&header, sizeof(header), 1, seek_index_file) != 1 ||
+      memcmp(&header, &expected, sizeof(header)))
+    return false;
+
+  seek_index_writable = true;
+
+  while (1) {
+    int entry[2];
+    long offset;
+
+    if (fread(entry, sizeof(entry), 1, seek_index_file) != 1)
+      break;
+
+    offset = ftell(seek_index_file);
+
+    if (
+      entry[1] <= 0 ||
+      (seek_entry_count && entry[0] <= seek_entries[seek_entry_count - 1].tic) ||
+      fseek(seek_index_file, entry[1], SEEK_CUR) ||
+      ftell(seek_index_file) - offset != entry[1]
+    ) {
+      // A partial entry from an interrupted playback; keep what came before it
+      seek_index_writable = false;
+      break;
+    }
+
+    dsda_AddSeekEntry(entry[0], entry[1], offset);
+  }
+
+  // fseek past the end succeeds, so check the last entry against the file size
+  if (seek_entry_count) {
+    seek_entry_t* last;
+
+    last = &seek_entries[seek_entry_count - 1];
+
+    fseek(seek_index_file, 0, SEEK_END);
+    if (ftell(seek_index_file) < last->offset + last->length) {
+      --seek_entry_count;
+      seek_index_writable = false;
+    }
+  }
+
+  return true;
+}
+
+// The same demo can play back against different wads, so they are part of the key
+static void dsda_GetSeekIndexCheckSum(dsda_cksum_t* cksum, const byte* demo, int length) {
+  struct MD5Context md5;
+  size_t i;
+
+  MD5Init(&md5);
+
+  MD5Update(&md5, demo, length);
+
+  for (i = 0; i < numwadfiles; ++i) {
+    const char* name;
+    int src;
+
+    name = PathFindFileName(wadfiles[i].name);
+    src = wadfiles[i].src;
+
+    MD5Update(&md5, (const md5byte*) name, strlen(name) + 1);
+    MD5Update(&md5, (const md5byte*) &src, sizeof(src));
+  }
+
+  MD5Update(&md5, (const md5byte*) &numlumps, sizeof(numlumps));
+
+  MD5Final(cksum->bytes, &md5);
+
+  dsda_TranslateCheckSum(cksum);
+}
+
+void dsda_OpenSeekIndex(const byte* demo, int length) {
+  dsda_arg_t* arg;
+  dsda_cksum_t cksum;
+  dsda_string_t path;
+
+  dsda_CloseSeekIndex();
+
+  arg = dsda_Arg(dsda_arg_seek_index);
+  if (!arg->found)
+    return;
+
+  seek_interval = 35 * arg->value.v_int;
+
+  dsda_GetSeekIndexCheckSum(&cksum, demo, length);
+  dsda_StringPrintF(&path, "%s/seek-%s.idx", dsda_DataDir(), cksum.string);
+
+  seek_index_file = M_OpenFile(path.string, "r+b");
+
+  if (!seek_index_file || !dsda_ReadSeekIndex()) {
+    seek_index_header_t header;
+
+    if (seek_index_file)
+      fclose(seek_index_file);
+
+    seek_entry_count = 0;
+    seek_index_file = M_OpenFile(path.string, "w+b");
+
+    if (!seek_index_file) {
+      lprintf(LO_WARN, "dsda_OpenSeekIndex: unable to open %s\n", path.string);
+      dsda_FreeString(&path);
+      return;
+    }
+
+    dsda_InitSeekIndexHeader(&header);
+    fwrite(&header, sizeof(header), 1, seek_index_file);
+    seek_index_writable = true;
+  }
+
+  lprintf(LO_INFO, "Seek index: %d key frames in %s\n", seek_entry_count, path.string);
+
+  dsda_FreeString(&path);
+}
+
+void dsda_CloseSeekIndex(void) {
+  if (seek_index_file) {
+    fclose(seek_index_file);
+    seek_index_file = NULL;
+  }
+
+  seek_entry_count = 0;
+  seek_index_writable = false;
+}
+
+void dsda_UpdateSeekIndex(void) {
+  int header[2];
+  long offset;
+
+  if (
+    !seek_index_file ||
+    !seek_index_writable ||
+    !demoplayback ||
+    gamestate != GS_LEVEL ||
+    gameaction != ga_nothing ||
+    logictic % seek_interval ||
+    (seek_entry_count && logictic <= seek_entries[seek_entry_count - 1].tic)
+  ) return;
+
+  dsda_StoreKeyFrame(&seek_key_frame, false, false, thinker_format_compact);
+
+  header[0] = seek_key_frame.game_tic_count;
+  header[1] = seek_key_frame.buffer_length;
+
+  fseek(seek_index_file, 0, SEEK_END);
+  offset = ftell(seek_index_file) + sizeof(header);
+
+  if (
+    fwrite(header, sizeof(header), 1, seek_index_file) != 1 ||
+    fwrite(seek_key_frame.buffer, seek_key_frame.buffer_length, 1, seek_index_file) != 1
+  ) {
+    lprintf(LO_WARN, "dsda_UpdateSeekIndex: failed to write key frame\n");
+    seek_index_writable = false;
+    return;
+  }
+
+  fflush(seek_index_file);
+
+  dsda_AddSeekEntry(header[0], header[1], offset);
+}
+
+// Restores the last indexed key frame after floor_tic and at or before tic
+dboolean dsda_RestoreSeekIndex(int tic, int floor_tic) {
+  dsda_key_frame_t key_frame = { 0 };
+  seek_entry_t* entry;
+  int low, high;
+
+  if (!seek_index_file || !seek_entry_count)
+    return false;
+
+  low = 0;
+  high = seek_entry_count;
+  while (low < high) {
+    int mid = (low + high) / 2;
+
+    if (seek_entries[mid].tic <= tic)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  if (!low)
+    return false;
+
+  entry = &seek_entries[low - 1];
+
+  if (entry->tic <= floor_tic)
+    return false;
+
+  key_frame.buffer = Z_Malloc(entry->length);
+  key_frame.buffer_length = entry->length;
+
+  if (
+    fseek(seek_index_file, entry->offset, SEEK_SET) ||
+    fread(key_frame.buffer, entry->length, 1, seek_index_file) != 1
+  ) {
+    Z_Free(key_frame.buffer);
+    return false;
+  }
+
+  dsda_RestoreKeyFrame(&key_frame, true);
+  Z_Free(key_frame.buffer);
+
+  return true;
+}
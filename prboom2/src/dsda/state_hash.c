@@ -0,0 +1,442 @@
+//
+// Copyright(C) 2026 by the dsda-doom contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA State Hash
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "info.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "m_random.h"
+#include "p_spec.h"
+#include "p_tick.h"
+#include "r_state.h"
+#include "w_wad.h"
+#include "z_zone.h"
+
+#include "state_hash.h"
+
+#define DSDA_STATE_HASH_VERSION 1
+
+// Object sums live in the field of integers modulo this prime
+#define STATE_HASH_PRIME 0x7fffffff
+
+typedef struct {
+  unsigned int count;
+  unsigned int sum[3];
+} dsda_object_hash_t;
+
+// Written as is, one per tic after the version: ten 32-bit values, 40 bytes
+typedef struct {
+  unsigned int rng;
+  unsigned int thinkers;
+  dsda_object_hash_t mobjs;
+  dsda_object_hash_t sectors;
+} dsda_state_hash_t;
+
+static FILE* state_hash_export;
+static FILE* state_hash_import;
+static int state_hash_tic;
+static int state_hash_mismatch_tic = -1;
+
+static unsigned int dsda_HashInt(unsigned int hash, int value) {
+  int i;
+
+  // FNV-1a, one byte at a time
+  for (i = 0; i < 4; ++i) {
+    hash ^= (value >> (i * 8)) & 0xff;
+    hash *= 16777619;
+  }
+
+  return hash;
+}
+
+// Each object adds its hash weighted by 1, its index, and its index squared,
+//   which is enough to recover the index when only one object differs
+static void dsda_AddObjectHash(dsda_object_hash_t* object_hash, unsigned int hash) {
+  unsigned long long weight;
+
+  weight = object_hash->count + 1;
+  hash %= STATE_HASH_PRIME;
+
+  object_hash->sum[0] = (object_hash->sum[0] + hash) % STATE_HASH_PRIME;
+  object_hash->sum[1] = (object_hash->sum[1] + weight * hash) % STATE_HASH_PRIME;
+  object_hash->sum[2] = (object_hash->sum[2] + weight * weight % STATE_HASH_PRIME * hash) %
+                        STATE_HASH_PRIME;
+
+  ++object_hash->count;
+}
+
+static unsigned long long dsda_ModPow(unsigned long long base, unsigned int exponent) {
+  unsigned long long result = 1;
+
+  base %= STATE_HASH_PRIME;
+
+  while (exponent) {
+    if (exponent & 1)
+      result = result * base % STATE_HASH_PRIME;
+
+    base = base * base % STATE_HASH_PRIME;
+    exponent >>= 1;
+  }
+
+  return result;
+}
+
+static int dsda_LocateObject(const dsda_object_hash_t* expected, const dsda_object_hash_t* actual) {
+  unsigned long long delta[3];
+  unsigned long long weight;
+  int i;
+
+  if (expected->count != actual->count)
+    return -1;
+
+  for (i = 0; i < 3; ++i)
+    delta[i] = (actual->sum[i] + STATE_HASH_PRIME - expected->sum[i]) % STATE_HASH_PRIME;
+
+  if (!delta[0])
+    return -1;
+
+  weight = delta[1] * dsda_ModPow(delta[0], STATE_HASH_PRIME - 2) % STATE_HASH_PRIME;
+
+  if (!weight || weight > actual->count ||
+      weight * weight % STATE_HASH_PRIME * delta[0] % STATE_HASH_PRIME != delta[2])
+    return -1;
+
+  return (int) weight - 1;
+}
+
+static unsigned int dsda_MobjHash(mobj_t* mobj) {
+  unsigned int hash = 2166136261u;
+
+  hash = dsda_HashInt(hash, mobj->type);
+  hash = dsda_HashInt(hash, mobj->x);
+  hash = dsda_HashInt(hash, mobj->y);
+  hash = dsda_HashInt(hash, mobj->z);
+  hash = dsda_HashInt(hash, mobj->momx);
+  hash = dsda_HashInt(hash, mobj->momy);
+  hash = dsda_HashInt(hash, mobj->momz);
+  hash = dsda_HashInt(hash, mobj->angle);
+  hash = dsda_HashInt(hash, mobj->health);
+  hash = dsda_HashInt(hash, mobj->tics);
+  hash = dsda_HashInt(hash, mobj->state ? (int) (mobj->state - states) : -1);
+  hash = dsda_HashInt(hash, (int) mobj->flags);
+
+  return hash;
+}
+
+static unsigned int dsda_SectorHash(sector_t* sector) {
+  unsigned int hash = 2166136261u;
+
+  hash = dsda_HashInt(hash, sector->floorheight);
+  hash = dsda_HashInt(hash, sector->ceilingheight);
+  hash = dsda_HashInt(hash, sector->lightlevel);
+  hash = dsda_HashInt(hash, sector->special);
+  hash = dsda_HashInt(hash, (sector->floordata != NULL) |
+                            (sector->ceilingdata != NULL) << 1 |
+                            (sector->lightingdata != NULL) << 2);
+
+  return hash;
+}
+
+static unsigned int dsda_HashSector(unsigned int hash, sector_t* sector) {
+  return dsda_HashInt(hash, sector ? (int) (sector - sectors) : -1);
+}
+
+// Movers and lights are named by a fixed code, since thinker functions
+//   are addresses that differ between builds
+static unsigned int dsda_ThinkerHash(unsigned int hash, thinker_t* th) {
+  if (th->function == T_MoveFloor) {
+    floormove_t* floor = (floormove_t*) th;
+
+    hash = dsda_HashInt(hash, 1);
+    hash = dsda_HashSector(hash, floor->sector);
+    hash = dsda_HashInt(hash, floor->type);
+    hash = dsda_HashInt(hash, floor->crush);
+    hash = dsda_HashInt(hash, floor->direction);
+    hash = dsda_HashInt(hash, floor->newspecial.special);
+    hash = dsda_HashInt(hash, floor->texture);
+    hash = dsda_HashInt(hash, floor->floordestheight);
+    hash = dsda_HashInt(hash, floor->speed);
+  }
+  else if (th->function == T_MoveCeiling) {
+    ceiling_t* ceiling = (ceiling_t*) th;
+
+    hash = dsda_HashInt(hash, 2);
+    hash = dsda_HashSector(hash, ceiling->sector);
+    hash = dsda_HashInt(hash, ceiling->type);
+    hash = dsda_HashInt(hash, ceiling->bottomheight);
+    hash = dsda_HashInt(hash, ceiling->topheight);
+    hash = dsda_HashInt(hash, ceiling->speed);
+    hash = dsda_HashInt(hash, ceiling->oldspeed);
+    hash = dsda_HashInt(hash, ceiling->crush);
+    hash = dsda_HashInt(hash, ceiling->newspecial.special);
+    hash = dsda_HashInt(hash, ceiling->texture);
+    hash = dsda_HashInt(hash, ceiling->direction);
+    hash = dsda_HashInt(hash, ceiling->tag);
+    hash = dsda_HashInt(hash, ceiling->olddirection);
+  }
+  else if (th->function == T_VerticalDoor) {
+    vldoor_t* door = (vldoor_t*) th;
+
+    hash = dsda_HashInt(hash, 3);
+    hash = dsda_HashSector(hash, door->sector);
+    hash = dsda_HashInt(hash, door->type);
+    hash = dsda_HashInt(hash, door->topheight);
+    hash = dsda_HashInt(hash, door->speed);
+    hash = dsda_HashInt(hash, door->direction);
+    hash = dsda_HashInt(hash, door->topwait);
+    hash = dsda_HashInt(hash, door->topcountdown);
+  }
+  else if (th->function == T_PlatRaise) {
+    plat_t* plat = (plat_t*) th;
+
+    hash = dsda_HashInt(hash, 4);
+    hash = dsda_HashSector(hash, plat->sector);
+    hash = dsda_HashInt(hash, plat->type);
+    hash = dsda_HashInt(hash, plat->speed);
+    hash = dsda_HashInt(hash, plat->low);
+    hash = dsda_HashInt(hash, plat->high);
+    hash = dsda_HashInt(hash, plat->wait);
+    hash = dsda_HashInt(hash, plat->count);
+    hash = dsda_HashInt(hash, plat->status);
+    hash = dsda_HashInt(hash, plat->oldstatus);
+    hash = dsda_HashInt(hash, plat->crush);
+    hash = dsda_HashInt(hash, plat->tag);
+  }
+  else if (th->function == T_MoveElevator) {
+    elevator_t* elevator = (elevator_t*) th;
+
+    hash = dsda_HashInt(hash, 5);
+    hash = dsda_HashSector(hash, elevator->sector);
+    hash = dsda_HashInt(hash, elevator->type);
+    hash = dsda_HashInt(hash, elevator->direction);
+    hash = dsda_HashInt(hash, elevator->floordestheight);
+    hash = dsda_HashInt(hash, elevator->ceilingdestheight);
+    hash = dsda_HashInt(hash, elevator->speed);
+  }
+  else if (th->function == T_LightFlash) {
+    lightflash_t* flash = (lightflash_t*) th;
+
+    hash = dsda_HashInt(hash, 6);
+    hash = dsda_HashSector(hash, flash->sector);
+    hash = dsda_HashInt(hash, flash->count);
+    hash = dsda_HashInt(hash, flash->maxlight);
+    hash = dsda_HashInt(hash, flash->minlight);
+    hash = dsda_HashInt(hash, flash->maxtime);
+    hash = dsda_HashInt(hash, flash->mintime);
+  }
+  else if (th->function == T_StrobeFlash) {
+    strobe_t* strobe = (strobe_t*) th;
+
+    hash = dsda_HashInt(hash, 7);
+    hash = dsda_HashSector(hash, strobe->sector);
+    hash = dsda_HashInt(hash, strobe->count);
+    hash = dsda_HashInt(hash, strobe->minlight);
+    hash = dsda_HashInt(hash, strobe->maxlight);
+    hash = dsda_HashInt(hash, strobe->darktime);
+    hash = dsda_HashInt(hash, strobe->brighttime);
+  }
+  else if (th->function == T_FireFlicker) {
+    fireflicker_t* flicker = (fireflicker_t*) th;
+
+    hash = dsda_HashInt(hash, 8);
+    hash = dsda_HashSector(hash, flicker->sector);
+    hash = dsda_HashInt(hash, flicker->count);
+    hash = dsda_HashInt(hash, flicker->maxlight);
+    hash = dsda_HashInt(hash, flicker->minlight);
+  }
+  else if (th->function == T_Glow) {
+    glow_t* glow = (glow_t*) th;
+
+    hash = dsda_HashInt(hash, 9);
+    hash = dsda_HashSector(hash, glow->sector);
+    hash = dsda_HashInt(hash, glow->minlight);
+    hash = dsda_HashInt(hash, glow->maxlight);
+    hash = dsda_HashInt(hash, glow->direction);
+  }
+
+  return hash;
+}
+
+static void dsda_ComputeStateHash(dsda_state_hash_t* state_hash) {
+  thinker_t* th;
+  int i;
+
+  memset(state_hash, 0, sizeof(*state_hash));
+
+  // The seeds start from the clock and are unused when demo compatibility is on
+  state_hash->rng = 2166136261u;
+  if (!demo_compatibility)
+    for (i = 0; i < NUMPRCLASS; ++i)
+      state_hash->rng = dsda_HashInt(state_hash->rng, rng.seed[i]);
+  state_hash->rng = dsda_HashInt(state_hash->rng, rng.rndindex);
+  state_hash->rng = dsda_HashInt(state_hash->rng, rng.prndindex);
+
+  // Thinker class sizes, then the state of every mover and light
+  state_hash->thinkers = 2166136261u;
+  for (i = 0; i < NUMTHCLASS; ++i) {
+    int count = 0;
+
+    for (th = thinkerclasscap[i].cnext; th != &thinkerclasscap[i]; th = th->cnext)
+      ++count;
+
+    state_hash->thinkers = dsda_HashInt(state_hash->thinkers, count);
+  }
+
+  for (th = thinkercap.next; th != &thinkercap; th = th->next)
+    if (th->function == P_MobjThinker)
+      dsda_AddObjectHash(&state_hash->mobjs, dsda_MobjHash((mobj_t*) th));
+    else
+      state_hash->thinkers = dsda_ThinkerHash(state_hash->thinkers, th);
+
+  for (i = 0; i < numsectors; ++i)
+    dsda_AddObjectHash(&state_hash->sectors, dsda_SectorHash(&sectors[i]));
+}
+
+static mobj_t* dsda_FindMobjByIndex(int index) {
+  thinker_t* th;
+
+  for (th = thinkercap.next; th != &thinkercap; th = th->next)
+    if (th->function == P_MobjThinker && !index--)
+      return (mobj_t*) th;
+
+  return NULL;
+}
+
+static void dsda_ReportStateHashMismatch(dsda_state_hash_t* expected, dsda_state_hash_t* actual) {
+  char message[512];
+  size_t length = 0;
+  int index;
+
+  message[0] = '\0';
+
+  // A truncated append leaves length at the end of the buffer
+#define APPEND(...) do { \
+    length += snprintf(message + length, sizeof(message) - length, __VA_ARGS__); \
+    if (length >= sizeof(message)) \
+      length = sizeof(message) - 1; \
+  } while (0)
+
+  if (expected->rng != actual->rng)
+    APPEND("\n  rng differs (index %d, prandom index %d)", rng.rndindex, rng.prndindex);
+
+  if (expected->thinkers != actual->thinkers)
+    APPEND("\n  movers, lights, or thinker counts differ");
+
+  if (memcmp(&expected->mobjs, &actual->mobjs, sizeof(actual->mobjs))) {
+    if (expected->mobjs.count != actual->mobjs.count)
+      APPEND("\n  mobj count is %u, expected %u", actual->mobjs.count, expected->mobjs.count);
+    else if ((index = dsda_LocateObject(&expected->mobjs, &actual->mobjs)) >= 0) {
+      mobj_t* mobj;
+
+      mobj = dsda_FindMobjByIndex(index);
+
+      APPEND("\n  mobj %d (type %d, health %d) differs, now at (%d, %d, %d) moving (%d, %d, %d)",
+             index, mobj->type, mobj->health,
+             mobj->x >> FRACBITS, mobj->y >> FRACBITS, mobj->z >> FRACBITS,
+             mobj->momx, mobj->momy, mobj->momz);
+    }
+    else
+      APPEND("\n  several mobjs differ");
+  }
+
+  if (memcmp(&expected->sectors, &actual->sectors, sizeof(actual->sectors))) {
+    if (expected->sectors.count != actual->sectors.count)
+      APPEND("\n  sector count is %u, expected %u", actual->sectors.count, expected->sectors.count);
+    else if ((index = dsda_LocateObject(&expected->sectors, &actual->sectors)) >= 0)
+      APPEND("\n  sector %d differs, now floor %d ceiling %d light %d", index,
+             sectors[index].floorheight >> FRACBITS, sectors[index].ceilingheight >> FRACBITS,
+             sectors[index].lightlevel);
+    else
+      APPEND("\n  several sectors differ");
+  }
+
+#undef APPEND
+
+  state_hash_mismatch_tic = state_hash_tic;
+
+  I_Error("State hash mismatch at tic %d (episode %d map %d, level time %d):%s",
+          state_hash_tic, gameepisode, gamemap, leveltime, message);
+}
+
+static FILE* dsda_OpenStateHashFile(const char* name, const char* mode) {
+  char* filename;
+  FILE* file;
+
+  filename = Z_Malloc(strlen(name) + 4 + 1);
+  AddDefaultExtension(strcpy(filename, name), ".sth");
+
+  file = M_OpenFile(filename, mode);
+
+  if (file == NULL)
+    I_Error("dsda_OpenStateHashFile: failed to open %s", filename);
+
+  Z_Free(filename);
+
+  return file;
+}
+
+void dsda_InitStateHashExport(const char* name) {
+  int version;
+
+  state_hash_export = dsda_OpenStateHashFile(name, "wb");
+
+  version = DSDA_STATE_HASH_VERSION;
+  fwrite(&version, sizeof(int), 1, state_hash_export);
+}
+
+void dsda_InitStateHashImport(const char* name) {
+  int version;
+
+  state_hash_import = dsda_OpenStateHashFile(name, "rb");
+
+  if (fread(&version, sizeof(int), 1, state_hash_import) != 1 || version != DSDA_STATE_HASH_VERSION)
+    I_Error("dsda_InitStateHashImport: unsupported state hash version %s", name);
+}
+
+int dsda_StateHashMismatchTic(void) {
+  return state_hash_mismatch_tic;
+}
+
+void dsda_UpdateStateHash(void) {
+  dsda_state_hash_t state_hash;
+
+  if (!state_hash_export && !state_hash_import)
+    return;
+
+  dsda_ComputeStateHash(&state_hash);
+
+  if (state_hash_export)
+    fwrite(&state_hash, sizeof(state_hash), 1, state_hash_export);
+
+  if (state_hash_import) {
+    dsda_state_hash_t expected;
+
+    if (fread(&expected, sizeof(expected), 1, state_hash_import) != 1) {
+      lprintf(LO_INFO, "State hash verified through tic %d\n", state_hash_tic);
+
+      fclose(state_hash_import);
+      state_hash_import = NULL;
+    }
+    else if (memcmp(&expected, &state_hash, sizeof(state_hash)))
+      dsda_ReportStateHashMismatch(&expected, &state_hash);
+  }
+
+  ++state_hash_tic;
+}
@@ -0,0 +1,26 @@
+//
+// Copyright(C) 2026 by the dsda-doom contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA State Hash
+//
+
+#ifndef __DSDA_STATE_HASH__
+#define __DSDA_STATE_HASH__
+
+void dsda_InitStateHashExport(const char* name);
+void dsda_InitStateHashImport(const char* name);
+void dsda_UpdateStateHash(void);
+int dsda_StateHashMismatchTic(void);
+
+#endif
@@ -0,0 +1,258 @@
+//
+// Copyright(C) 2026 by the dsda-doom contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Thread Pool
+//
+
+#include "SDL.h"
+#include "SDL_thread.h"
+
+#include "i_system.h"
+#include "lprintf.h"
+
+#include "dsda/args.h"
+
+#include "thread_pool.h"
+
+#define MAX_THREADS 16
+#define TASK_SLOTS 64
+#define TASK_RING (4 * TASK_SLOTS)
+
+typedef enum {
+  task_free,
+  task_queued,
+  task_running,
+  task_done,
+} task_state_t;
+
+typedef struct {
+  dsda_task_t func;
+  void* data;
+  task_state_t state;
+} task_slot_t;
+
+typedef struct {
+  dsda_range_task_t func;
+  void* data;
+  int start;
+  int end;
+} range_t;
+
+static int thread_count;
+static int worker_count;
+static SDL_Thread* workers[MAX_THREADS];
+static SDL_mutex* pool_mutex;
+static SDL_cond* task_ready;
+static SDL_cond* task_finished;
+static dboolean pool_quit;
+
+static task_slot_t slots[TASK_SLOTS];
+
+// Slots waiting for a worker, oldest first. Entries whose slot was claimed
+// by dsda_FinishTask in the meantime are skipped when popped.
+static int ring[TASK_RING];
+static unsigned int ring_head;
+static unsigned int ring_tail;
+
+static int dsda_Worker(void* unused) {
+  SDL_LockMutex(pool_mutex);
+
+  while (1) {
+    task_slot_t* slot;
+
+    while (ring_head == ring_tail && !pool_quit)
+      SDL_CondWait(task_ready, pool_mutex);
+
+    if (pool_quit)
+      break;
+
+    slot = &slots[ring[ring_head++ % TASK_RING]];
+
+    if (slot->state != task_queued)
+      continue;
+
+    slot->state = task_running;
+    SDL_UnlockMutex(pool_mutex);
+
+    slot->func(slot->data);
+
+    SDL_LockMutex(pool_mutex);
+    slot->state = task_done;
+    SDL_CondBroadcast(task_finished);
+  }
+
+  SDL_UnlockMutex(pool_mutex);
+
+  return 0;
+}
+
+static void dsda_StopThreadPool(void) {
+  int i;
+
+  SDL_LockMutex(pool_mutex);
+  pool_quit = true;
+  SDL_CondBroadcast(task_ready);
+  SDL_UnlockMutex(pool_mutex);
+
+  for (i = 0; i < worker_count; ++i)
+    SDL_WaitThread(workers[i], NULL);
+
+  worker_count = 0;
+}
+
+static void dsda_StartThreadPool(void) {
+  dsda_arg_t* arg;
+
+  arg = dsda_Arg(dsda_arg_threads);
+  thread_count = arg->found ? arg->value.v_int : SDL_GetCPUCount();
+
+  if (thread_count > MAX_THREADS)
+    thread_count = MAX_THREADS;
+  if (thread_count < 1)
+    thread_count = 1;
+
+  if (thread_count == 1)
+    return;
+
+  pool_mutex = SDL_CreateMutex();
+  task_ready = SDL_CreateCond();
+  task_finished = SDL_CreateCond();
+
+  if (!pool_mutex || !task_ready || !task_finished) {
+    lprintf(LO_WARN, "dsda_StartThreadPool: %s\n", SDL_GetError());
+    thread_count = 1;
+    return;
+  }
+
+  for (worker_count = 0; worker_count < thread_count - 1; ++worker_count) {
+    workers[worker_count] = SDL_CreateThread(dsda_Worker, "dsda_Worker", NULL);
+
+    if (!workers[worker_count]) {
+      lprintf(LO_WARN, "dsda_StartThreadPool: %s\n", SDL_GetError());
+      break;
+    }
+  }
+
+  thread_count = worker_count + 1;
+
+  I_AtExit(dsda_StopThreadPool, false, "dsda_StopThreadPool", exit_priority_normal);
+}
+
+int dsda_ThreadCount(void) {
+  if (!thread_count)
+    dsda_StartThreadPool();
+
+  return thread_count;
+}
+
+// Returns an id for dsda_FinishTask, or -1 if the task already ran
+int dsda_QueueTask(dsda_task_t task, void* data) {
+  int i;
+
+  if (dsda_ThreadCount() == 1) {
+    task(data);
+    return -1;
+  }
+
+  SDL_LockMutex(pool_mutex);
+
+  if (ring_tail - ring_head < TASK_RING)
+    for (i = 0; i < TASK_SLOTS; ++i)
+      if (slots[i].state == task_free) {
+        slots[i].func = task;
+        slots[i].data = data;
+        slots[i].state = task_queued;
+        ring[ring_tail++ % TASK_RING] = i;
+        SDL_CondSignal(task_ready);
+        SDL_UnlockMutex(pool_mutex);
+
+        return i;
+      }
+
+  SDL_UnlockMutex(pool_mutex);
+
+  task(data);
+
+  return -1;
+}
+
+// Waits for a queued task to complete, running it here if no worker took it
+void dsda_FinishTask(int id) {
+  task_slot_t* slot;
+
+  if (id < 0)
+    return;
+
+  slot = &slots[id];
+
+  SDL_LockMutex(pool_mutex);
+
+  if (slot->state == task_queued) {
+    slot->state = task_running;
+    SDL_UnlockMutex(pool_mutex);
+
+    slot->func(slot->data);
+
+    SDL_LockMutex(pool_mutex);
+  }
+  else {
+    while (slot->state != task_done)
+      SDL_CondWait(task_finished, pool_mutex);
+  }
+
+  slot->state = task_free;
+
+  SDL_UnlockMutex(pool_mutex);
+}
+
+static void dsda_RunRange(void* data) {
+  range_t* range = data;
+
+  range->func(range->start, range->end, range->data);
+}
+
+// Splits [0, count) into one range per thread, none smaller than grain
+void dsda_ParallelFor(int count, int grain, dsda_range_task_t task, void* data) {
+  range_t ranges[MAX_THREADS];
+  int ids[MAX_THREADS];
+  int chunks;
+  int i;
+
+  if (grain < 1)
+    grain = 1;
+
+  chunks = (count + grain - 1) / grain;
+  if (chunks > dsda_ThreadCount())
+    chunks = dsda_ThreadCount();
+
+  if (chunks <= 1) {
+    if (count > 0)
+      task(0, count, data);
+
+    return;
+  }
+
+  for (i = 1; i < chunks; ++i) {
+    ranges[i].func = task;
+    ranges[i].data = data;
+    ranges[i].start = (long long) count * i / chunks;
+    ranges[i].end = (long long) count * (i + 1) / chunks;
+    ids[i] = dsda_QueueTask(dsda_RunRange, &ranges[i]);
+  }
+
+  task(0, count / chunks, data);
+
+  for (i = 1; i < chunks; ++i)
+    dsda_FinishTask(ids[i]);
+}
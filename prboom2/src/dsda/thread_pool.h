@@ -0,0 +1,32 @@
+//
+// Copyright(C) 2026 by the dsda-doom contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Thread Pool
+//
+//  Tasks run on persistent worker threads. They must not touch the zone
+//  allocator, I_Error, or lprintf, none of which are thread safe.
+//
+
+#ifndef __DSDA_THREAD_POOL__
+#define __DSDA_THREAD_POOL__
+
+typedef void (*dsda_task_t)(void* data);
+typedef void (*dsda_range_task_t)(int start, int end, void* data);
+
+int dsda_ThreadCount(void);
+int dsda_QueueTask(dsda_task_t task, void* data);
+void dsda_FinishTask(int id);
+void dsda_ParallelFor(int count, int grain, dsda_range_task_t task, void* data);
+
+#endif
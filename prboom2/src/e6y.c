@@ -85,6 +85,7 @@
 #include "m_file.h"
 
 #include "dsda/args.h"
+#include "dsda/batch.h"
 #include "dsda/map_format.h"
 #include "dsda/mapinfo.h"
 #include "dsda/playback.h"
@@ -196,7 +197,7 @@ void M_ChangeShorttics(void)
 
 void e6y_InitCommandLine(void)
 {
-  stats_level = dsda_Flag(dsda_arg_levelstat);
+  stats_level = dsda_Flag(dsda_arg_levelstat) || dsda_BatchJob();
 
   if ((stroller = dsda_Flag(dsda_arg_stroller)))
     dsda_UpdateIntArg(dsda_arg_turbo, "50");
@@ -449,6 +450,7 @@ void e6y_G_DoCompleted(void)
   int i;
 
   dsda_EvaluateSkipModeDoCompleted();
+  dsda_RecordBatchLevelExit();
 
   if(!stats_level)
     return;
@@ -492,7 +494,8 @@ void e6y_G_DoCompleted(void)
 
   numlevels++;
 
-  e6y_WriteStats();
+  if (dsda_Flag(dsda_arg_levelstat))
+    e6y_WriteStats();
 }
 
 typedef struct tmpdata_s
@@ -505,12 +508,6 @@ typedef struct tmpdata_s
 void e6y_WriteStats(void)
 {
   FILE *f;
-  char str[200];
-  int i, level, playerscount;
-  timetable_t max;
-  tmpdata_t tmp;
-  tmpdata_t *all;
-  size_t allkills_len=0, allitems_len=0, allsecrets_len=0;
 
   f = M_OpenFile("levelstat.txt", "wb");
 
@@ -520,6 +517,22 @@ void e6y_WriteStats(void)
     return;
   }
 
+  e6y_PrintStats(f);
+  fclose(f);
+}
+
+void e6y_PrintStats(FILE *f)
+{
+  char str[200];
+  int i, level, playerscount;
+  timetable_t max;
+  tmpdata_t tmp;
+  tmpdata_t *all;
+  size_t allkills_len=0, allitems_len=0, allsecrets_len=0;
+
+  if (!numlevels)
+    return;
+
   all = Z_Malloc(sizeof(*all) * numlevels);
   memset(&max, 0, sizeof(timetable_t));
 
@@ -598,7 +611,6 @@ void e6y_WriteStats(void)
   }
 
   Z_Free(all);
-  fclose(f);
 }
 
 //--------------------------------------------------
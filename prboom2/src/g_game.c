@@ -98,6 +98,7 @@
 #include "dsda/key_frame.h"
 #include "dsda/messenger.h"
 #include "dsda/save.h"
+#include "dsda/seek_index.h"
 #include "dsda/settings.h"
 #include "dsda/input.h"
 #include "dsda/map_format.h"
@@ -1449,6 +1450,7 @@ void G_Ticker (void)
     int buf = gametic % BACKUPTICS;
 
     dsda_UpdateAutoKeyFrames();
+    dsda_UpdateSeekIndex();
 
     if (dsda_BruteForce())
     {
@@ -3827,6 +3829,7 @@ void G_StartDemoPlayback(const byte *buffer, int length, int behaviour)
 
   demo_p = G_ReadDemoHeaderEx(demobuffer, demolength, RDH_SAFE);
   dsda_AttachPlaybackStream(demo_p, demolength, behaviour);
+  dsda_OpenSeekIndex(demobuffer, demolength);
 
   R_SmoothPlaying_Reset(NULL); // e6y
 }
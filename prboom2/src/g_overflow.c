@@ -232,7 +232,7 @@ void SpechitOverrun(spechit_overrun_param_t *params)
 {
   int numspechit = *(params->numspechit);
 
-  if (!hexen && demo_compatibility && numspechit > 8)
+  if (!hexen && demo_compatibility && numspechit > MAXSPECIALCROSS_ORIGINAL)
   {
     line_t **spechit = *(params->spechit);
 
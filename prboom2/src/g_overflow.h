@@ -78,6 +78,7 @@ extern const char *overflow_cfgname[OVERFLOW_MAX];
 // as well as little endian machines.
 
 #define MAXINTERCEPTS_ORIGINAL 128
+#define MAXSPECIALCROSS_ORIGINAL 8
 
 typedef struct
 {
@@ -448,7 +448,7 @@ static void StartOpenACS(int number, int infoIndex, int offset)
 {
     acs_t *script;
 
-    script = Z_MallocLevel(sizeof(acs_t));
+    script = Z_PoolMalloc(sizeof(acs_t));
     memset(script, 0, sizeof(acs_t));
     script->number = number;
 
@@ -511,7 +511,7 @@ dboolean P_StartACS(int number, int map, byte * args, mobj_t * activator,
     {                           // Script is already executing
         return false;
     }
-    script = Z_MallocLevel(sizeof(acs_t));
+    script = Z_PoolMalloc(sizeof(acs_t));
     memset(script, 0, sizeof(acs_t));
     script->number = number;
     script->infoIndex = infoIndex;
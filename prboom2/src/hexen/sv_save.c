@@ -1447,7 +1447,7 @@ static void UnarchiveMobjs(void)
     MobjList = Z_Malloc(MobjCount * sizeof(mobj_t *));
     for (i = 0; i < MobjCount; i++)
     {
-        MobjList[i] = Z_MallocLevel(sizeof(mobj_t));
+        MobjList[i] = Z_PoolMalloc(sizeof(mobj_t));
         memset(MobjList[i], 0, sizeof(mobj_t));
     }
     for (i = 0; i < MobjCount; i++)
@@ -1656,7 +1656,7 @@ static void UnarchiveThinkers(void)
         {
             if (tClass == info->tClass)
             {
-                thinker = Z_MallocLevel(info->size);
+                thinker = Z_PoolMalloc(info->size);
                 memset(thinker, 0, info->size);
                 info->readFunc(thinker);
                 thinker->function = info->thinkerFunc;
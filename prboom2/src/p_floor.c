@@ -499,7 +499,7 @@ int EV_DoFloor
 
     // new floor thinker
     rtn = 1;
-    floor = Z_MallocLevel (sizeof(*floor));
+    floor = Z_PoolMalloc(sizeof(*floor));
     memset(floor, 0, sizeof(*floor));
     P_AddThinker (&floor->thinker);
     sec->floordata = floor; //jff 2/22/98
@@ -794,7 +794,7 @@ int EV_BuildStairs
 
       // create new floor thinker for first step
       rtn = 1;
-      floor = Z_MallocLevel (sizeof(*floor));
+      floor = Z_PoolMalloc(sizeof(*floor));
       memset(floor, 0, sizeof(*floor));
       P_AddThinker (&floor->thinker);
       sec->floordata = floor;
@@ -911,7 +911,7 @@ int EV_BuildStairs
           oldsecnum = newsecnum;
 
           // create and initialize a thinker for the next step
-          floor = Z_MallocLevel (sizeof(*floor));
+          floor = Z_PoolMalloc(sizeof(*floor));
           memset(floor, 0, sizeof(*floor));
           P_AddThinker (&floor->thinker);
 
@@ -1063,7 +1063,7 @@ int P_SpawnDonut(int secnum, line_t *line, fixed_t pillarspeed, fixed_t slimespe
     }
 
     //  Spawn rising slime
-    floor = Z_MallocLevel(sizeof(*floor));
+    floor = Z_PoolMalloc(sizeof(*floor));
     memset(floor, 0, sizeof(*floor));
     P_AddThinker(&floor->thinker);
     s2->floordata = floor; //jff 2/22/98
@@ -1077,7 +1077,7 @@ int P_SpawnDonut(int secnum, line_t *line, fixed_t pillarspeed, fixed_t slimespe
     floor->floordestheight = s3_floorheight;
 
     //  Spawn lowering donut-hole pillar
-    floor = Z_MallocLevel(sizeof(*floor));
+    floor = Z_PoolMalloc(sizeof(*floor));
     memset(floor, 0, sizeof(*floor));
     P_AddThinker(&floor->thinker);
     s1->floordata = floor; //jff 2/22/98
@@ -1131,7 +1131,7 @@ void P_SpawnElevator(sector_t *sec, line_t *line, elevator_e type, fixed_t speed
 {
   elevator_t *elevator;
 
-  elevator = Z_MallocLevel(sizeof(*elevator));
+  elevator = Z_PoolMalloc(sizeof(*elevator));
   memset(elevator, 0, sizeof(*elevator));
   P_AddThinker(&elevator->thinker);
   sec->floordata = elevator; //jff 2/22/98
@@ -1253,7 +1253,7 @@ static void P_SpawnZDoomFloor(sector_t *sec, floor_e floortype, line_t *line,
 {
   floormove_t *floor;
 
-  floor = Z_MallocLevel (sizeof(*floor));
+  floor = Z_PoolMalloc(sizeof(*floor));
   memset(floor, 0, sizeof(*floor));
   P_AddThinker(&floor->thinker);
   sec->floordata = floor;
@@ -1448,7 +1448,7 @@ int Hexen_EV_DoFloor(line_t * line, byte * args, floor_e floortype)
         //      new floor thinker
         //
         rtn = 1;
-        floor = Z_MallocLevel(sizeof(*floor));
+        floor = Z_PoolMalloc(sizeof(*floor));
         memset(floor, 0, sizeof(*floor));
         P_AddThinker(&floor->thinker);
         sec->floordata = floor;
@@ -1644,7 +1644,7 @@ static void ProcessStairSector(sector_t * sec, int type, int height,
     // new floor thinker
     //
     height += StepDelta;
-    floor = Z_MallocLevel(sizeof(*floor));
+    floor = Z_PoolMalloc(sizeof(*floor));
     memset(floor, 0, sizeof(*floor));
     P_AddThinker(&floor->thinker);
     sec->floordata = floor;
@@ -1743,7 +1743,7 @@ static void P_SpawnZDoomStair(sector_t *sec, stair_e type, fixed_t stairstep,
 {
   floormove_t *floor;
 
-  floor = Z_MallocLevel(sizeof(*floor));
+  floor = Z_PoolMalloc(sizeof(*floor));
   memset(floor, 0, sizeof(*floor));
   P_AddThinker(&floor->thinker);
   sec->floordata = floor;
@@ -2038,7 +2038,7 @@ void P_SpawnZDoomPillar(sector_t *sec, pillar_e type, fixed_t speed,
 {
   pillar_t *pillar;
 
-  pillar = Z_MallocLevel(sizeof(*pillar));
+  pillar = Z_PoolMalloc(sizeof(*pillar));
   memset(pillar, 0, sizeof(*pillar));
   sec->floordata = pillar;
   sec->ceilingdata = pillar;
@@ -2153,7 +2153,7 @@ int EV_BuildPillar(line_t * line, byte * args, int crush)
             newHeight = sec->floorheight + (args[2] << FRACBITS);
         }
 
-        pillar = Z_MallocLevel(sizeof(*pillar));
+        pillar = Z_PoolMalloc(sizeof(*pillar));
         memset(pillar, 0, sizeof(*pillar));
         sec->floordata = pillar;
         P_AddThinker(&pillar->thinker);
@@ -2209,7 +2209,7 @@ int EV_OpenPillar(line_t * line, byte * args)
             continue;
         }
         rtn = 1;
-        pillar = Z_MallocLevel(sizeof(*pillar));
+        pillar = Z_PoolMalloc(sizeof(*pillar));
         memset(pillar, 0, sizeof(*pillar));
         sec->floordata = pillar;
         P_AddThinker(&pillar->thinker);
@@ -2384,7 +2384,7 @@ static void P_SpawnPlaneWaggle(sector_t *sector, int height, int speed,
 {
   planeWaggle_t *waggle;
 
-  waggle = Z_MallocLevel(sizeof(*waggle));
+  waggle = Z_PoolMalloc(sizeof(*waggle));
   memset(waggle, 0, sizeof(*waggle));
   if (ceiling)
   {
@@ -182,7 +182,7 @@ void P_SpawnFireFlicker (sector_t*  sector)
 
   P_ClearNonGeneralizedSectorSpecial(sector);
 
-  flick = Z_MallocLevel ( sizeof(*flick));
+  flick = Z_PoolMalloc(sizeof(*flick));
 
   memset(flick, 0, sizeof(*flick));
   P_AddThinker (&flick->thinker);
@@ -209,7 +209,7 @@ void P_SpawnLightFlash (sector_t* sector)
 
   P_ClearNonGeneralizedSectorSpecial(sector);
 
-  flash = Z_MallocLevel ( sizeof(*flash));
+  flash = Z_PoolMalloc(sizeof(*flash));
 
   memset(flash, 0, sizeof(*flash));
   P_AddThinker (&flash->thinker);
@@ -242,7 +242,7 @@ void P_SpawnStrobeFlash
 {
   strobe_t* flash;
 
-  flash = Z_MallocLevel ( sizeof(*flash));
+  flash = Z_PoolMalloc(sizeof(*flash));
 
   memset(flash, 0, sizeof(*flash));
   P_AddThinker (&flash->thinker);
@@ -278,7 +278,7 @@ void P_SpawnGlowingLight(sector_t*  sector)
 {
   glow_t* g;
 
-  g = Z_MallocLevel( sizeof(*g));
+  g = Z_PoolMalloc(sizeof(*g));
 
   memset(g, 0, sizeof(*g));
   P_AddThinker(&g->thinker);
@@ -531,7 +531,7 @@ static void P_SpawnZDoomLightGlow(sector_t *sec, short startlevel, short endleve
 {
   zdoom_glow_t *g;
 
-  g = Z_MallocLevel(sizeof(*g));
+  g = Z_PoolMalloc(sizeof(*g));
 
   memset(g, 0, sizeof(*g));
   P_AddThinker(&g->thinker);
@@ -615,7 +615,7 @@ static void P_SpawnZDoomLightFlicker(sector_t *sec, short upper, short lower)
 {
   zdoom_flicker_t *g;
 
-  g = Z_MallocLevel(sizeof(*g));
+  g = Z_PoolMalloc(sizeof(*g));
 
   memset(g, 0, sizeof(*g));
   P_AddThinker(&g->thinker);
@@ -648,7 +648,7 @@ static void P_SpawnZDoomLightStrobe(sector_t *sector, int upper, int lower,
 {
   strobe_t* g;
 
-  g = Z_MallocLevel ( sizeof(*g));
+  g = Z_PoolMalloc(sizeof(*g));
 
   memset(g, 0, sizeof(*g));
   P_AddThinker (&g->thinker);
@@ -821,7 +821,7 @@ dboolean EV_SpawnLight(line_t * line, byte * arg, lighttype_t type)
         think = false;
         sec = &sectors[*id_p];
 
-        light = (light_t *) Z_MallocLevel(sizeof(light_t));
+        light = (light_t *) Z_PoolMalloc(sizeof(light_t));
         light->type = type;
         light->sector = sec;
         light->count = 0;
@@ -934,7 +934,7 @@ void P_SpawnPhasedLight(sector_t * sector, int base, int index)
 {
     phase_t *phase;
 
-    phase = Z_MallocLevel(sizeof(*phase));
+    phase = Z_PoolMalloc(sizeof(*phase));
     P_AddThinker(&phase->thinker);
     phase->sector = sector;
     sector->lightingdata = phase;
@@ -82,6 +82,13 @@ static int ls_y; // Lost Soul position for Lost Soul checks      // phares
 static int crushchange;
 static dboolean nofit;
 
+// Sector check counters, and a count of sector thread changes
+int sector_checks;
+int sector_checks_idle;
+int sector_things_checked;
+int sector_rescans_skipped;
+static unsigned int secnode_changes;
+
 // If "floatok" true, move would be ok
 // if within "tmfloorz - tmceilingz".
 
@@ -120,6 +127,9 @@ static int    tmunstuck;     /* killough 8/1/98: whether to allow unsticking */
 line_t **spechit;                // new code -- killough
 static int spechit_max;          // killough
 
+level_peaks_t level_peaks;
+static int secnodes_live;
+
 int numspechit;
 
 // Temporary holder for thing_sectorlist threads
@@ -1306,7 +1316,7 @@ dboolean P_CheckPosition (mobj_t* thing,fixed_t x,fixed_t y)
 
   for (bx=xl ; bx<=xh ; bx++)
     for (by=yl ; by<=yh ; by++)
-      if (!P_BlockThingsIterator(bx,by,PIT_CheckThing))
+      if (!P_BlockThingsIteratorBox(bx,by,tmbbox,PIT_CheckThing))
         return false;
 
   if (hexen && tmflags & MF_NOCLIP)
@@ -2765,6 +2775,7 @@ void P_RadiusAttack(mobj_t* spot,mobj_t* source, int damage, int distance, dbool
   int yh;
 
   fixed_t dist;
+  fixed_t bbox[4];
 
   dist = (distance+MAXRADIUS)<<FRACBITS;
   yh = P_GetSafeBlockY(spot->y + dist - bmaporgy);
@@ -2783,9 +2794,16 @@ void P_RadiusAttack(mobj_t* spot,mobj_t* source, int damage, int distance, dbool
   bombdamage = damage;
   bombdistance = distance;
   DamageSource = damageSource;
+
+  // PIT_RadiusAttack ignores things whose edge is beyond distance
+  bbox[BOXTOP] = spot->y + (distance<<FRACBITS);
+  bbox[BOXBOTTOM] = spot->y - (distance<<FRACBITS);
+  bbox[BOXRIGHT] = spot->x + (distance<<FRACBITS);
+  bbox[BOXLEFT] = spot->x - (distance<<FRACBITS);
+
   for (y=yl ; y<=yh ; y++)
     for (x=xl ; x<=xh ; x++)
-      P_BlockThingsIterator (x, y, PIT_RadiusAttack );
+      P_BlockThingsIteratorBox (x, y, bbox, PIT_RadiusAttack );
 
   if (map_format.zdoom)
   {
@@ -2912,6 +2930,8 @@ dboolean P_ChangeSector(sector_t* sector, int crunch)
   int   x;
   int   y;
 
+  P_ClearSightCache();
+
   nofit = false;
   crushchange = crunch;
 
@@ -2933,6 +2953,8 @@ dboolean P_ChangeSector(sector_t* sector, int crunch)
 
 void P_InitSectorSearch(mobj_in_sector_t *data, sector_t *sector)
 {
+  secnode_changes++; // resets the visited marks
+
   data->sector = sector;
 
   for (data->node = data->sector->touching_thinglist;
@@ -2970,12 +2992,23 @@ dboolean P_CheckSector(sector_t* sector, int crunch)
   if (comp[comp_floors]) /* use the old routine for old demos though */
     return P_ChangeSector(sector,crunch);
 
+  P_ClearSightCache();
+
   nofit = false;
   crushchange = crunch;
 
   if (crushchange == STAIRS_UNINITIALIZED_CRUSH_FIELD_VALUE)
     crushchange = DOOM_CRUSH;
 
+  sector_checks++;
+  secnode_changes++; // a check nested in PIT_ChangeSector resets the marks
+
+  if (!sector->touching_thinglist)
+  {
+    sector_checks_idle++;
+    return nofit;
+  }
+
   // killough 4/4/98: scan list front-to-back until empty or exhausted,
   // restarting from beginning after each thing is processed. Avoids
   // crashes, and is sure to examine all things in the sector, and only
@@ -2989,16 +3022,36 @@ dboolean P_CheckSector(sector_t* sector, int crunch)
   for (n=sector->touching_thinglist; n; n=n->m_snext)
     n->visited = false;
 
-  do
-    for (n=sector->touching_thinglist; n; n=n->m_snext)  // go through list
-      if (!n->visited)               // unprocessed thing found
+  // If no sector thread changed while processing a thing, everything
+  // before it is still marked, so the restart can pick up after it.
+
+  n = sector->touching_thinglist;
+  while (n)
+    {
+    for (; n; n=n->m_snext)  // go through list
+      if (!n->visited)       // unprocessed thing found
+        break;
+
+    if (n)
+      {
+      unsigned int changes = secnode_changes;
+
+      n->visited  = true;          // mark thing as processed
+      if (!(n->m_thing->flags & MF_NOBLOCKMAP)) //jff 4/7/98 don't do these
+        {
+        PIT_ChangeSector(n->m_thing);    // process it
+        sector_things_checked++;
+        }
+
+      if (changes == secnode_changes)
         {
-        n->visited  = true;          // mark thing as processed
-        if (!(n->m_thing->flags & MF_NOBLOCKMAP)) //jff 4/7/98 don't do these
-          PIT_ChangeSector(n->m_thing);    // process it
-        break;                 // exit and start over
+        n = n->m_snext;
+        sector_rescans_skipped++;
         }
-  while (n);  // repeat from scratch until all things left are marked valid
+      else
+        n = sector->touching_thinglist;  // start over
+      }
+    }  // repeat until all things left are marked valid
 
   return nofit;
 }
@@ -3020,10 +3073,14 @@ void P_FreeSecNodeList(void)
 {
   DECLARE_BLOCK_MEMORY_ALLOC_ZONE(secnodezone);
   NULL_BLOCK_MEMORY_ALLOC_ZONE(secnodezone);
+  secnodes_live = 0;
 }
 
 msecnode_t* P_GetSecnode(void)
 {
+  if (++secnodes_live > level_peaks.secnodes)
+    level_peaks.secnodes = secnodes_live;
+
   return (msecnode_t*)Z_BMalloc(&secnodezone);
 }
 
@@ -3031,6 +3088,7 @@ msecnode_t* P_GetSecnode(void)
 
 inline static void P_PutSecnode(msecnode_t* node)
 {
+  secnodes_live--;
   Z_BFree(&secnodezone, node);
 }
 #else // USE_BLOCK_MEMORY_ALLOCATOR
@@ -3046,6 +3104,7 @@ msecnode_t *headsecnode = NULL;
 void P_FreeSecNodeList(void)
 {
    headsecnode = NULL; // this is all thats needed to fix the bug
+   secnodes_live = 0;
 }
 
 //
@@ -3060,6 +3119,9 @@ msecnode_t *P_GetSecnode(void)
 {
   msecnode_t *node;
 
+  if (++secnodes_live > level_peaks.secnodes)
+    level_peaks.secnodes = secnodes_live;
+
   return headsecnode ?
     node = headsecnode, headsecnode = node->m_snext, node :
   (msecnode_t *)(Z_MallocLevel(sizeof *node));
@@ -3072,6 +3134,7 @@ msecnode_t *P_GetSecnode(void)
 //
 static void P_PutSecnode(msecnode_t *node)
 {
+  secnodes_live--;
   node->m_snext = headsecnode;
   headsecnode = node;
 }
@@ -3103,6 +3166,7 @@ msecnode_t* P_AddSecnode(sector_t* s, mobj_t* thing, msecnode_t* nextnode)
   // of the list.
 
   node = P_GetSecnode();
+  secnode_changes++;
 
   // killough 4/4/98, 4/7/98: mark new nodes unvisited.
   node->visited = 0;
@@ -3164,6 +3228,7 @@ msecnode_t* P_DelSecnode(msecnode_t* node)
     // Return this node to the freelist
 
     P_PutSecnode(node);
+    secnode_changes++;
     return(tn);
     }
   return(NULL);
@@ -3524,16 +3589,38 @@ void P_FakeZMovement(mobj_t * mo)
     }
 }
 
+// Each line is hit at most once per check, so this covers the whole level
+void P_ReserveSpecHits(int count)
+{
+  if (count > spechit_max) {
+    spechit_max = count;
+    spechit = Z_Realloc(spechit,sizeof *spechit*spechit_max);
+  }
+}
+
+void P_ResetLevelPeaks(void)
+{
+  if (level_peaks.intercepts || level_peaks.spechits || level_peaks.secnodes)
+    lprintf(LO_DEBUG, "Level peaks: %d intercepts, %d spechits, %d secnodes, %d regrowths\n",
+            level_peaks.intercepts, level_peaks.spechits, level_peaks.secnodes,
+            level_peaks.regrowths);
+
+  memset(&level_peaks, 0, sizeof(level_peaks));
+}
+
 void P_AppendSpecHit(line_t * ld)
 {
   // 1/11/98 killough: remove limit on lines hit, by array doubling
   if (numspechit >= spechit_max) {
     spechit_max = spechit_max ? spechit_max*2 : 8;
     spechit = Z_Realloc(spechit,sizeof *spechit*spechit_max); // killough
+    level_peaks.regrowths++;
   }
   spechit[numspechit++] = ld;
+  if (numspechit > level_peaks.spechits)
+    level_peaks.spechits = numspechit;
   // e6y: Spechits overrun emulation code
-  if (numspechit > 8 && demo_compatibility)
+  if (numspechit > MAXSPECIALCROSS_ORIGINAL && demo_compatibility)
   {
     static spechit_overrun_param_t spechit_overrun_param = {
       NULL,          // line_t *line;
@@ -60,7 +60,31 @@ dboolean P_TeleportMove(mobj_t *thing, fixed_t x, fixed_t y,dboolean boss);
 void    P_UnqualifiedMove(mobj_t *thing, fixed_t x, fixed_t y);
 void    P_SlideMove(mobj_t *mo);
 dboolean P_CheckSight(mobj_t *t1, mobj_t *t2);
+void    P_ClearSightCache(void);
 dboolean P_CheckFov(mobj_t *t1, mobj_t *t2, angle_t fov);
+
+extern int sight_cache_hits;
+extern int sight_cache_misses;
+extern int sight_cache_clears;
+
+// Largest use of the growable play arrays on the current level,
+// and how often one had to grow mid-level
+typedef struct
+{
+  int intercepts;
+  int spechits;
+  int secnodes;
+  int regrowths;
+} level_peaks_t;
+
+extern level_peaks_t level_peaks;
+void    P_ReserveSpecHits(int count);
+void    P_ResetLevelPeaks(void);
+
+extern int sector_checks;
+extern int sector_checks_idle;
+extern int sector_things_checked;
+extern int sector_rescans_skipped;
 void    P_UseLines(player_t *player);
 
 typedef dboolean (*CrossSubsectorFunc)(int num);
@@ -44,9 +44,12 @@
 #include "lprintf.h"
 #include "g_game.h"
 #include "g_overflow.h"
+#include "i_system.h"
 #include "e6y.h"//e6y
 
+#include "dsda/args.h"
 #include "dsda/map_format.h"
+#include "dsda/time.h"
 
 //
 // P_AproxDistance
@@ -309,6 +312,163 @@ void P_LineOpening(const line_t *linedef, const mobj_t *actor)
 // THING POSITION SETTING
 //
 
+//
+// THING INDEX
+//
+// Blocks holding many things get a finer grid of buckets, so that box
+// queries can skip things too far away to be touched. Every block link
+// takes a new order stamp and links at the head, so a block list is
+// always newest first; merging the buckets by stamp then visits things
+// in exactly the order of the block list.
+//
+
+#define THING_INDEX_SHIFT   (MAPBLOCKSHIFT-2)   // 32 unit buckets
+#define THING_INDEX_SIDE    (1<<(MAPBLOCKSHIFT-THING_INDEX_SHIFT))
+#define THING_INDEX_MASK    (THING_INDEX_SIDE-1)
+#define THING_INDEX_OUTSIDE (THING_INDEX_SIDE*THING_INDEX_SIDE)
+#define THING_INDEX_CROWDED 64
+
+typedef struct
+{
+  // One extra bucket for things whose position has left the block
+  mobj_t *buckets[THING_INDEX_OUTSIDE + 1];
+} thing_index_t;
+
+static thing_index_t **thing_index;
+static unsigned long long thing_link_order;
+static unsigned int thing_index_epoch; // bumped by unlinks and box queries
+static fixed_t thing_index_radius;
+
+void P_InitThingIndex(void)
+{
+  int i;
+
+  thing_index = NULL;
+
+  if (!dsda_Flag(dsda_arg_thing_index))
+    return;
+
+  thing_index = Z_CallocLevel(blocklinks_count, sizeof(*thing_index));
+
+  // Radii are only trusted up to the largest a thing type starts with
+  thing_index_radius = MAXRADIUS;
+  for (i = 0; i < num_mobj_types; i++)
+    if (mobjinfo[i].radius > thing_index_radius)
+      thing_index_radius = mobjinfo[i].radius;
+}
+
+static int P_ThingIndexBucket(const mobj_t *thing, int block)
+{
+  int x = thing->x - bmaporgx;
+  int y = thing->y - bmaporgy;
+
+  if (P_GetSafeBlockX(x) != block % bmapwidth || P_GetSafeBlockY(y) != block / bmapwidth)
+    return THING_INDEX_OUTSIDE;
+
+  return ((y >> THING_INDEX_SHIFT) & THING_INDEX_MASK) * THING_INDEX_SIDE +
+         ((x >> THING_INDEX_SHIFT) & THING_INDEX_MASK);
+}
+
+static void P_UnlinkThingIndex(mobj_t *thing)
+{
+  // inext is left alone, as iterators step past removed things with it
+  mobj_t **iprev = thing->iprev;
+  mobj_t *inext = thing->inext;
+  if ((*iprev = inext))
+    inext->iprev = iprev;
+  thing->iprev = NULL;
+}
+
+// Links a thing into its bucket, after any newer things already there
+static void P_LinkThingIndex(mobj_t *thing, int block)
+{
+  mobj_t **link;
+
+  thing->ibucket = P_ThingIndexBucket(thing, block);
+
+  link = &thing_index[block]->buckets[thing->ibucket];
+  while (*link && (*link)->blockorder > thing->blockorder)
+    link = &(*link)->inext;
+
+  if ((thing->inext = *link))
+    thing->inext->iprev = &thing->inext;
+  thing->iprev = link;
+  *link = thing;
+}
+
+static void P_BuildThingIndex(int block)
+{
+  mobj_t **tails[THING_INDEX_OUTSIDE + 1];
+  mobj_t *mobj;
+  int i;
+
+  thing_index[block] = Z_CallocLevel(1, sizeof(**thing_index));
+
+  for (i = 0; i <= THING_INDEX_OUTSIDE; i++)
+    tails[i] = &thing_index[block]->buckets[i];
+
+  // The block list is newest first, so appending keeps each bucket in order
+  for (mobj = blocklinks[block]; mobj; mobj = mobj->bnext)
+  {
+    mobj->ibucket = P_ThingIndexBucket(mobj, block);
+    mobj->inext = NULL;
+    mobj->iprev = tails[mobj->ibucket];
+    *tails[mobj->ibucket] = mobj;
+    tails[mobj->ibucket] = &mobj->inext;
+  }
+}
+
+// Renumbers the block lists after they were restored wholesale
+void P_ResetThingIndex(void)
+{
+  unsigned long long base;
+  int i;
+
+  if (!thing_index)
+    return;
+
+  base = thing_link_order;
+
+  for (i = 0; i < blocklinks_count; i++)
+  {
+    unsigned long long order;
+    mobj_t *mobj;
+
+    if (thing_index[i])
+    {
+      Z_Free(thing_index[i]);
+      thing_index[i] = NULL;
+    }
+
+    order = base;
+    for (mobj = blocklinks[i]; mobj; mobj = mobj->bnext)
+      order++;
+
+    if (order > thing_link_order)
+      thing_link_order = order;
+
+    for (mobj = blocklinks[i]; mobj; mobj = mobj->bnext)
+    {
+      mobj->blockorder = order--;
+      mobj->iprev = NULL;
+    }
+  }
+}
+
+// Moves things whose position was written without relinking them into
+// the right bucket. Buckets are only trusted right after this runs.
+static void P_RefreshThingIndex(int block)
+{
+  mobj_t *mobj;
+
+  for (mobj = blocklinks[block]; mobj; mobj = mobj->bnext)
+    if (P_ThingIndexBucket(mobj, block) != mobj->ibucket)
+    {
+      P_UnlinkThingIndex(mobj);
+      P_LinkThingIndex(mobj, block);
+    }
+}
+
 //
 // P_UnsetThingPosition
 // Unlinks a thing from block map and sectors.
@@ -366,6 +526,13 @@ void P_UnsetThingPosition (mobj_t *thing)
       mobj_t *bnext, **bprev = thing->bprev;
       if (bprev && (*bprev = bnext = thing->bnext))  // unlink from block map
         bnext->bprev = bprev;
+
+      if (thing_index)
+      {
+        thing_index_epoch++;
+        if (thing->iprev)
+          P_UnlinkThingIndex(thing);
+      }
     }
 }
 
@@ -413,6 +580,7 @@ void P_SetThingPosition(mobj_t *thing)
     }
 
   // link into blockmap
+  thing->iprev = NULL; // not trusted from savegames
   if (!(thing->flags & MF_NOBLOCKMAP))
     {
       // inert things don't need to be in blockmap
@@ -429,6 +597,15 @@ void P_SetThingPosition(mobj_t *thing)
           bnext->bprev = &thing->bnext;
         thing->bprev = link;
         *link = thing;
+
+        if (thing_index)
+        {
+          int block = blocky*bmapwidth+blockx;
+
+          thing->blockorder = ++thing_link_order;
+          if (thing_index[block])
+            P_LinkThingIndex(thing, block);
+        }
       }
       else        // thing is off the map
         thing->bnext = NULL, thing->bprev = NULL;
@@ -617,6 +794,103 @@ dboolean P_BlockThingsIterator(int x, int y, dboolean func(mobj_t*))
   return true;
 }
 
+//
+// P_BlockThingsIteratorBox
+//
+// Like P_BlockThingsIterator, for functions that ignore any thing whose
+// origin is farther than its radius outside bbox. Skipping those calls
+// changes nothing, so crowded blocks only visit the buckets near bbox.
+//
+
+dboolean P_BlockThingsIteratorBox(int x, int y, const fixed_t *bbox,
+                                  dboolean func(mobj_t *))
+{
+  mobj_t *heads[THING_INDEX_OUTSIDE + 1];
+  thing_index_t *index;
+  mobj_t *mobj;
+  int block, count;
+  int xl, xh, yl, yh, bx, by;
+
+  if (x<0 || y<0 || x>=bmapwidth || y>=bmapheight)
+    return true;
+
+  if (!thing_index)
+    return P_BlockThingsIterator(x, y, func);
+
+  thing_index_epoch++;
+  block = y*bmapwidth+x;
+  index = thing_index[block];
+
+  if (!index)
+  {
+    count = 0;
+    for (mobj = blocklinks[block]; mobj; mobj = mobj->bnext, count++)
+      if (!func(mobj))
+        return false;
+
+    if (count >= THING_INDEX_CROWDED && blocklinks[block])
+      P_BuildThingIndex(block);
+
+    return true;
+  }
+
+  P_RefreshThingIndex(block);
+
+  xl = bbox[BOXLEFT] - thing_index_radius - bmaporgx;
+  xh = bbox[BOXRIGHT] + thing_index_radius - bmaporgx;
+  yl = bbox[BOXBOTTOM] - thing_index_radius - bmaporgy;
+  yh = bbox[BOXTOP] + thing_index_radius - bmaporgy;
+
+  count = 0;
+  heads[count++] = index->buckets[THING_INDEX_OUTSIDE];
+
+  if (P_GetSafeBlockX(xl) <= x && P_GetSafeBlockX(xh) >= x &&
+      P_GetSafeBlockY(yl) <= y && P_GetSafeBlockY(yh) >= y)
+  {
+    xl = P_GetSafeBlockX(xl) < x ? 0 : (xl >> THING_INDEX_SHIFT) & THING_INDEX_MASK;
+    xh = P_GetSafeBlockX(xh) > x ? THING_INDEX_MASK : (xh >> THING_INDEX_SHIFT) & THING_INDEX_MASK;
+    yl = P_GetSafeBlockY(yl) < y ? 0 : (yl >> THING_INDEX_SHIFT) & THING_INDEX_MASK;
+    yh = P_GetSafeBlockY(yh) > y ? THING_INDEX_MASK : (yh >> THING_INDEX_SHIFT) & THING_INDEX_MASK;
+
+    for (by = yl; by <= yh; by++)
+      for (bx = xl; bx <= xh; bx++)
+        heads[count++] = index->buckets[by * THING_INDEX_SIDE + bx];
+  }
+
+  while (1)
+  {
+    unsigned int epoch;
+    int i, newest = -1;
+
+    for (i = 0; i < count; i++)
+      if (heads[i] && (newest < 0 || heads[i]->blockorder > heads[newest]->blockorder))
+        newest = i;
+
+    if (newest < 0)
+      return true;
+
+    mobj = heads[newest];
+    epoch = thing_index_epoch;
+
+    if (!func(mobj))
+      return false;
+
+    // Once func has unlinked things or run queries of its own, the buckets
+    // or the globals behind bbox may have changed, so continue as the
+    // plain iterator would
+    if (epoch != thing_index_epoch)
+    {
+      for (mobj = mobj->bnext; mobj; mobj = mobj->bnext)
+        if (!func(mobj))
+          return false;
+
+      return true;
+    }
+
+    heads[newest] = mobj->inext;
+  }
+}
+
 //
 // INTERCEPT ROUTINES
 //
@@ -624,17 +898,40 @@ dboolean P_BlockThingsIterator(int x, int y, dboolean func(mobj_t*))
 // 1/11/98 killough: Intercept limit removed
 intercept_t *intercepts, *intercept_p;
 
+static size_t num_intercepts;
+static unsigned int intercept_adds; // for noticing nested traversals
+
+static void P_ReserveInterceptHeap(int count);
+
+// Sizes the list for a level up front, so traversals don't reallocate
+// mid-tic. Only things can take a traversal past the line count.
+void P_ReserveIntercepts(int count)
+{
+  if ((size_t) count > num_intercepts)
+    {
+      size_t offset = intercept_p - intercepts;
+      num_intercepts = count;
+      intercepts = Z_Realloc(intercepts, sizeof(*intercepts)*num_intercepts);
+      intercept_p = intercepts + offset;
+    }
+
+  P_ReserveInterceptHeap(count);
+}
+
 // Check for limit and double size if necessary -- killough
 void check_intercept(void)
 {
-  static size_t num_intercepts;
   size_t offset = intercept_p - intercepts;
+  intercept_adds++;
   if (offset >= num_intercepts)
     {
       num_intercepts = num_intercepts ? num_intercepts*2 : 128;
       intercepts = Z_Realloc(intercepts, sizeof(*intercepts)*num_intercepts);
       intercept_p = intercepts + offset;
+      level_peaks.regrowths++;
     }
+  if ((int) offset >= level_peaks.intercepts)
+    level_peaks.intercepts = offset + 1;
 }
 
 divline_t trace;
@@ -746,6 +1043,225 @@ dboolean PIT_AddThingIntercepts(mobj_t *thing)
   return true;          // keep going
 }
 
+//
+// INTERCEPT ORDERING
+//
+// Intercepts are visited nearest first, and among equal fracs the one
+// added first, which is what the original repeated scans picked. A heap
+// over (frac, index) gives the same order without rescanning the list for
+// every intercept, which matters for hitscans through large crowds.
+//
+
+typedef struct
+{
+  fixed_t frac;
+  int index;
+} intercept_order_t;
+
+static intercept_order_t *intercept_heap;
+static int intercept_heap_size;
+
+static dboolean P_InterceptBefore(const intercept_order_t *a, const intercept_order_t *b)
+{
+  return a->frac < b->frac || (a->frac == b->frac && a->index < b->index);
+}
+
+static void P_SiftInterceptHeap(int i, int count)
+{
+  intercept_order_t item = intercept_heap[i];
+
+  while (1)
+  {
+    int child = 2 * i + 1;
+
+    if (child >= count)
+      break;
+
+    if (child + 1 < count && P_InterceptBefore(&intercept_heap[child + 1], &intercept_heap[child]))
+      child++;
+
+    if (!P_InterceptBefore(&intercept_heap[child], &item))
+      break;
+
+    intercept_heap[i] = intercept_heap[child];
+    i = child;
+  }
+
+  intercept_heap[i] = item;
+}
+
+static void P_ReserveInterceptHeap(int count)
+{
+  if (count > intercept_heap_size)
+  {
+    intercept_heap_size = count;
+    intercept_heap = Z_Realloc(intercept_heap, intercept_heap_size * sizeof(*intercept_heap));
+  }
+}
+
+static void P_BuildInterceptHeap(const intercept_t *base, int count)
+{
+  int i;
+
+  if (count > intercept_heap_size)
+    P_ReserveInterceptHeap(count * 2);
+
+  for (i = 0; i < count; i++)
+  {
+    intercept_heap[i].frac = base[i].frac;
+    intercept_heap[i].index = i;
+  }
+
+  for (i = count / 2 - 1; i >= 0; i--)
+    P_SiftInterceptHeap(i, count);
+}
+
+// Removes the nearest intercept from the heap and returns its index
+static int P_PopInterceptHeap(int *count)
+{
+  int index = intercept_heap[0].index;
+
+  if (--*count)
+  {
+    intercept_heap[0] = intercept_heap[*count];
+    P_SiftInterceptHeap(0, *count);
+  }
+
+  return index;
+}
+
+// The original selection: the first intercept with the smallest frac.
+// Leaves in alone if every frac is INT_MAX.
+static intercept_t *P_ScanIntercepts(intercept_t *base, intercept_t *end,
+                                     intercept_t *in, fixed_t *dist)
+{
+  intercept_t *scan;
+
+  *dist = INT_MAX;
+  for (scan = base; scan < end; scan++)
+    if (scan->frac < *dist)
+      *dist = (in=scan)->frac;
+
+  return in;
+}
+
+//
+// Intercept ordering benchmark
+//
+// -bench_intercepts records the fracs of every traversal, and on exit
+// orders them all again with both the original scan and the heap,
+// reporting the time each takes and whether their orders agree.
+//
+
+#define INTERCEPT_BENCH_LIMIT (1 << 24)
+#define INTERCEPT_BENCH_ROUNDS 4
+
+static int bench_intercepts = -1;
+static int *intercept_traces;
+static int intercept_trace_length;
+static int intercept_trace_size;
+
+static void P_RecordIntercepts(void)
+{
+  int count = intercept_p - intercepts;
+  int i;
+
+  if (intercept_trace_length + count + 1 > INTERCEPT_BENCH_LIMIT)
+    return;
+
+  if (intercept_trace_length + count + 1 > intercept_trace_size)
+  {
+    while (intercept_trace_length + count + 1 > intercept_trace_size)
+      intercept_trace_size = intercept_trace_size ? intercept_trace_size * 2 : 4096;
+
+    intercept_traces = Z_Realloc(intercept_traces, intercept_trace_size * sizeof(*intercept_traces));
+  }
+
+  intercept_traces[intercept_trace_length++] = count;
+  for (i = 0; i < count; i++)
+    intercept_traces[intercept_trace_length++] = intercepts[i].frac;
+}
+
+// Orders every recorded trace, returning a hash of the visiting order
+static unsigned int P_ReplayIntercepts(intercept_t *scratch, dboolean heap)
+{
+  unsigned int hash = 0;
+  int position = 0;
+
+  while (position < intercept_trace_length)
+  {
+    int count = intercept_traces[position++];
+    int i;
+
+    for (i = 0; i < count; i++)
+      scratch[i].frac = intercept_traces[position++];
+
+    if (heap)
+    {
+      int heap_count = count;
+
+      P_BuildInterceptHeap(scratch, count);
+      while (heap_count && intercept_heap[0].frac < INT_MAX)
+        hash = hash * 31 + P_PopInterceptHeap(&heap_count);
+    }
+    else
+    {
+      intercept_t *in = NULL;
+      fixed_t dist;
+
+      for (i = 0; i < count; i++)
+      {
+        in = P_ScanIntercepts(scratch, scratch + count, in, &dist);
+        if (dist == INT_MAX)
+          break;
+
+        hash = hash * 31 + (int) (in - scratch);
+        in->frac = INT_MAX;
+      }
+    }
+  }
+
+  return hash;
+}
+
+static void P_BenchIntercepts(void)
+{
+  unsigned long long time[2] = { 0 };
+  unsigned int hash[2] = { 0 };
+  intercept_t *scratch;
+  int traces = 0, total = 0, longest = 0;
+  int position, round, method;
+
+  for (position = 0; position < intercept_trace_length; position += intercept_traces[position] + 1)
+  {
+    traces++;
+    total += intercept_traces[position];
+    if (intercept_traces[position] > longest)
+      longest = intercept_traces[position];
+  }
+
+  if (!total)
+    return;
+
+  scratch = Z_Calloc(longest, sizeof(*scratch));
+
+  for (round = 0; round < INTERCEPT_BENCH_ROUNDS; round++)
+    for (method = 0; method < 2; method++)
+    {
+      dsda_StartTimer(dsda_timer_temp);
+      hash[method] = P_ReplayIntercepts(scratch, method);
+      time[method] += dsda_ElapsedTime(dsda_timer_temp);
+    }
+
+  Z_Free(scratch);
+
+  lprintf(LO_INFO, "Intercept ordering: %d traversals, %d intercepts (%d max), "
+                   "scan %llu us, heap %llu us, orders %s\n",
+          traces, total, longest,
+          time[0] / INTERCEPT_BENCH_ROUNDS, time[1] / INTERCEPT_BENCH_ROUNDS,
+          hash[0] == hash[1] ? "match" : "differ");
+}
+
 //
 // P_TraverseIntercepts
 // Returns true if the traverser function returns true
@@ -757,18 +1273,47 @@ dboolean P_TraverseIntercepts(traverser_t func, fixed_t maxfrac)
 {
   intercept_t *in = NULL;
   int count = intercept_p - intercepts;
+  int heap_count = count;
+  dboolean ordered = true;
+
+  if (bench_intercepts < 0)
+  {
+    bench_intercepts = dsda_Flag(dsda_arg_bench_intercepts);
+
+    if (bench_intercepts)
+      I_AtExit(P_BenchIntercepts, true, "P_BenchIntercepts", exit_priority_normal);
+  }
+
+  if (bench_intercepts)
+    P_RecordIntercepts();
+
+  P_BuildInterceptHeap(intercepts, count);
+
   while (count--)
     {
       fixed_t dist = INT_MAX;
-      intercept_t *scan;
-      for (scan = intercepts; scan < intercept_p; scan++)
-        if (scan->frac < dist)
-          dist = (in=scan)->frac;
+      intercept_t *end;
+      unsigned int adds;
+
+      if (!ordered)
+        in = P_ScanIntercepts(intercepts, intercept_p, in, &dist);
+      else if (intercept_heap[0].frac < INT_MAX)
+        dist = (in = &intercepts[P_PopInterceptHeap(&heap_count)])->frac;
+
       if (dist > maxfrac)
         return true;    // checked everything in range
+
+      end = intercept_p;
+      adds = intercept_adds;
+
       if (!func(in))
         return false;           // don't bother going farther
       in->frac = INT_MAX;
+
+      // A traversal started by func replaces the list under us,
+      // so carry on scanning whatever it left, as the original did
+      if (intercept_p != end || intercept_adds != adds)
+        ordered = false;
     }
   return true;                  // everything was traversed
 }
@@ -96,6 +96,7 @@ int PUREFUNC P_ZDoomPointOnDivlineSide(fixed_t x, fixed_t y, const divline_t *li
 extern int (*P_PointOnDivlineSide)(fixed_t x, fixed_t y, const divline_t *line);
 
 void check_intercept(void);
+void P_ReserveIntercepts(int count);
 
 void    P_LineOpening (const line_t *linedef, const mobj_t *actor);
 void    P_UnsetThingPosition(mobj_t *thing);
@@ -103,6 +104,10 @@ void    P_SetThingPosition(mobj_t *thing);
 dboolean P_BlockLinesIterator (int x, int y, dboolean func(line_t *));
 dboolean P_BlockLinesIterator2(int x, int y, dboolean func(line_t *));
 dboolean P_BlockThingsIterator(int x, int y, dboolean func(mobj_t *));
+dboolean P_BlockThingsIteratorBox(int x, int y, const fixed_t *bbox,
+                                  dboolean func(mobj_t *));
+void    P_InitThingIndex(void);
+void    P_ResetThingIndex(void);
 dboolean P_PathTraverse(fixed_t x1, fixed_t y1, fixed_t x2, fixed_t y2,
                        int flags, dboolean trav(intercept_t *));
 
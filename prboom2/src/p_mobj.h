@@ -298,6 +298,13 @@ typedef struct mobj_s
     struct mobj_s*      bnext;
     struct mobj_s**     bprev; // killough 8/11/98: change to ptr-to-ptr
 
+    // Links in the thing index of a crowded block, by position within it.
+    // blockorder grows with every block link, so each block is newest first.
+    struct mobj_s*      inext;
+    struct mobj_s**     iprev;
+    int                 ibucket;
+    unsigned long long  blockorder;
+
     struct subsector_s* subsector;
 
     // The closest interval over all contacted Sectors.
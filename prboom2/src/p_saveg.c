@@ -35,6 +35,7 @@
 
 #include "doomstat.h"
 #include "r_main.h"
+#include "p_map.h"
 #include "p_maputl.h"
 #include "p_spec.h"
 #include "p_tick.h"
@@ -62,9 +63,33 @@
 
 #define SAVEGAMESIZE 0x20000
 
+// Released save buffers are kept here so that repeated key frame stores
+//   can serialize without touching the heap
+#define SAVE_BUFFER_POOL_SIZE 4
+
+typedef struct
+{
+  byte *buffer;
+  size_t size;
+} save_buffer_t;
+
+typedef struct
+{
+  int episode;
+  int map;
+  size_t length;
+} save_size_hint_t;
+
 byte *save_p;
 byte *savebuffer;
-static int savegamesize;
+static size_t savegamesize;
+static dboolean savebuffer_pooled;
+
+static save_buffer_t save_buffer_pool[SAVE_BUFFER_POOL_SIZE];
+static int save_buffer_pool_count;
+
+static save_size_hint_t *save_size_hints;
+static int save_size_hint_count;
 
 // Check for overrun and realloc if necessary -- Lee Killough 1/22/98
 void CheckSaveGame(size_t size)
@@ -85,21 +110,150 @@ void CheckSaveGame(size_t size)
   save_p = savebuffer + offset;
 }
 
+static save_size_hint_t *P_SaveSizeHint(void)
+{
+  int i;
+
+  for (i = 0; i < save_size_hint_count; ++i)
+    if (save_size_hints[i].episode == gameepisode && save_size_hints[i].map == gamemap)
+      return &save_size_hints[i];
+
+  return NULL;
+}
+
+// The next buffer for this map starts at the size of the last one, plus some room to grow
+static void P_UpdateSaveSizeHint(void)
+{
+  save_size_hint_t *hint;
+
+  hint = P_SaveSizeHint();
+
+  if (!hint)
+  {
+    save_size_hints = Z_Realloc(save_size_hints, (save_size_hint_count + 1) * sizeof(*save_size_hints));
+    hint = &save_size_hints[save_size_hint_count++];
+    hint->episode = gameepisode;
+    hint->map = gamemap;
+  }
+
+  hint->length = save_p - savebuffer;
+}
+
+void P_ReleaseSaveBuffer(byte *buffer, size_t size)
+{
+  int i, smallest;
+
+  if (!buffer)
+    return;
+
+  if (save_buffer_pool_count < SAVE_BUFFER_POOL_SIZE)
+  {
+    save_buffer_pool[save_buffer_pool_count].buffer = buffer;
+    save_buffer_pool[save_buffer_pool_count].size = size;
+    ++save_buffer_pool_count;
+    return;
+  }
+
+  smallest = 0;
+  for (i = 1; i < save_buffer_pool_count; ++i)
+    if (save_buffer_pool[i].size < save_buffer_pool[smallest].size)
+      smallest = i;
+
+  if (size <= save_buffer_pool[smallest].size)
+  {
+    Z_Free(buffer);
+    return;
+  }
+
+  Z_Free(save_buffer_pool[smallest].buffer);
+  save_buffer_pool[smallest].buffer = buffer;
+  save_buffer_pool[smallest].size = size;
+}
+
 void P_InitSaveBuffer(void)
 {
-  savegamesize = SAVEGAMESIZE;
-  save_p = savebuffer = Z_Malloc(savegamesize);
+  save_size_hint_t *hint;
+  size_t size;
+  int i, best;
+
+  hint = P_SaveSizeHint();
+  size = hint && hint->length ? hint->length + hint->length / 8 : SAVEGAMESIZE;
+
+  // Prefer the smallest pooled buffer that fits, else grow the largest one
+  best = -1;
+  for (i = 0; i < save_buffer_pool_count; ++i)
+  {
+    if (best < 0)
+      best = i;
+    else if (save_buffer_pool[best].size >= size)
+    {
+      if (save_buffer_pool[i].size >= size && save_buffer_pool[i].size < save_buffer_pool[best].size)
+        best = i;
+    }
+    else if (save_buffer_pool[i].size > save_buffer_pool[best].size)
+      best = i;
+  }
+
+  if (best >= 0)
+  {
+    savebuffer = save_buffer_pool[best].buffer;
+    savegamesize = save_buffer_pool[best].size;
+    save_buffer_pool[best] = save_buffer_pool[--save_buffer_pool_count];
+
+    if (savegamesize < size)
+    {
+      savegamesize = size;
+      savebuffer = Z_Realloc(savebuffer, savegamesize);
+    }
+  }
+  else
+  {
+    savegamesize = size;
+    savebuffer = Z_Malloc(savegamesize);
+  }
+
+  save_p = savebuffer;
+  savebuffer_pooled = true;
+}
+
+size_t P_SaveBufferSize(void)
+{
+  return savegamesize;
+}
+
+size_t P_SaveBufferPoolSize(void)
+{
+  size_t total = 0;
+  int i;
+
+  for (i = 0; i < save_buffer_pool_count; ++i)
+    total += save_buffer_pool[i].size;
+
+  return total;
 }
 
 void P_ForgetSaveBuffer(void)
 {
+  if (savebuffer_pooled)
+    P_UpdateSaveSizeHint();
+
   save_p = savebuffer = NULL;
+  savebuffer_pooled = false;
 }
 
 void P_FreeSaveBuffer(void)
 {
-  Z_Free(savebuffer);
-  P_ForgetSaveBuffer();
+  // Buffers read from disk aren't sized by P_InitSaveBuffer
+  if (savebuffer_pooled)
+  {
+    P_UpdateSaveSizeHint();
+    P_ReleaseSaveBuffer(savebuffer, savegamesize);
+  }
+  else
+    Z_Free(savebuffer);
+
+  save_p = savebuffer = NULL;
+  savebuffer_pooled = false;
 }
 
 //
@@ -257,6 +411,8 @@ void P_UnArchiveWorld (void)
   sector_t     *sec;
   line_t       *li;
 
+  P_ClearSightCache();
+
   for (i = 0, sec = sectors; i < numsectors; i++, sec++)
   {
     P_LOAD_X(sec->floorheight);
@@ -728,9 +884,366 @@ typedef enum {
   tc_true_poly_move,
   tc_true_poly_door,
   tc_true_quake,
-  tc_true_end
+  tc_true_end,
+  tc_true_format // followed by a thinker format version, kept after tc_true_end for old saves
 } true_thinkerclass_t;
 
+thinker_format_t thinker_archive_format = thinker_format_struct;
+
+// Thinker format ids written after tc_true_format
+#define THINKER_FORMAT_COMPACT 1
+#define THINKER_FORMAT_PACKED 2
+
+// The mobj fields that hold game state, in stream order
+#define MOBJ_ARCHIVED_FIELDS(F) \
+  F(type) F(thinker.references) F(x) F(y) F(z) F(angle) F(sprite) F(frame) \
+  F(subsector) F(floorz) F(ceilingz) F(dropoffz) F(radius) F(height) \
+  F(momx) F(momy) F(momz) F(validcount) F(tics) F(state) F(flags) \
+  F(intflags) F(health) F(movedir) F(movecount) F(strafecount) F(target) \
+  F(reactiontime) F(threshold) F(pursuecount) F(gear) F(player) F(lastlook) \
+  F(spawnpoint.tid) F(spawnpoint.x) F(spawnpoint.y) F(spawnpoint.height) \
+  F(spawnpoint.angle) F(spawnpoint.type) F(spawnpoint.options) \
+  F(spawnpoint.special) F(spawnpoint.special_args[0]) \
+  F(spawnpoint.special_args[1]) F(spawnpoint.special_args[2]) \
+  F(spawnpoint.special_args[3]) F(spawnpoint.special_args[4]) \
+  F(spawnpoint.gravity) F(spawnpoint.health) F(spawnpoint.alpha) F(tracer) \
+  F(lastenemy) F(friction) F(movefactor) F(PrevX) F(PrevY) F(PrevZ) \
+  F(pitch) F(index) F(patch_width) F(iden_nums) F(damage) F(flags2) \
+  F(special1.i) F(special1.m) F(special2.i) F(special2.m) F(floorpic) \
+  F(floorclip) F(archiveNum) F(tid) F(special) F(special_args[0]) \
+  F(special_args[1]) F(special_args[2]) F(special_args[3]) \
+  F(special_args[4]) F(gravity) F(alpha) F(color)
+
+// Links and cached pointers are rebuilt on load, so they stay out of the stream
+#define MOBJ_EXCLUDED_FIELDS(F) \
+  F(thinker.prev) F(thinker.next) F(thinker.function) F(thinker.cnext) \
+  F(thinker.cprev) F(snext) F(sprev) F(bnext) F(bprev) F(inext) F(iprev) \
+  F(ibucket) F(blockorder) F(info) F(touching_sectorlist) F(tranmap)
+
+#define MOBJ_FIELD_SIZE(f) + sizeof(((mobj_t *) 0)->f)
+
+// Alignment padding in the 64 bit layout of mobj_t and its nested structs
+#define MOBJ_PADDING 45
+
+// A field added to mobj_t must go in one of the lists above, or key frames
+// silently lose it. 32 bit layouts pad differently and aren't checked.
+typedef char mobj_fields_match_mobj_t[
+  sizeof(void *) != 8 ||
+  sizeof(mobj_t) == MOBJ_PADDING
+                    MOBJ_ARCHIVED_FIELDS(MOBJ_FIELD_SIZE)
+                    MOBJ_EXCLUDED_FIELDS(MOBJ_FIELD_SIZE) ? 1 : -1
+];
+
+typedef struct
+{
+  unsigned short offset;
+  unsigned short size;
+} mobj_field_t;
+
+#define MOBJ_FIELD(f) { offsetof(mobj_t, f), sizeof(((mobj_t *) 0)->f) },
+
+static const mobj_field_t mobj_fields[] = {
+  MOBJ_ARCHIVED_FIELDS(MOBJ_FIELD)
+};
+
+#define MOBJ_FIELD_COUNT (sizeof(mobj_fields) / sizeof(mobj_fields[0]))
+
+static int packed_mobj_size;
+
+// The last mobj of each type in the stream, which the next one is coded against
+static mobj_t *compact_baselines;
+static byte *compact_baseline_set;
+static int compact_baseline_count;
+
+static int P_PackedMobjSize(void)
+{
+  if (!packed_mobj_size)
+  {
+    int i;
+
+    for (i = 0; i < MOBJ_FIELD_COUNT; ++i)
+      packed_mobj_size += mobj_fields[i].size;
+  }
+
+  return packed_mobj_size;
+}
+
+// Fields are widened with their sign so small negative deltas stay small
+static int64_t P_GetMobjField(const mobj_t *mobj, const mobj_field_t *field)
+{
+  const byte *p = (const byte *) mobj + field->offset;
+
+  switch (field->size)
+  {
+    case 1:
+      return *(const int8_t *) p;
+    case 2:
+      {
+        int16_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+      }
+    case 4:
+      {
+        int32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+      }
+    default:
+      {
+        int64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+      }
+  }
+}
+
+static void P_SetMobjField(mobj_t *mobj, const mobj_field_t *field, int64_t value)
+{
+  byte *p = (byte *) mobj + field->offset;
+
+  switch (field->size)
+  {
+    case 1:
+      *(int8_t *) p = (int8_t) value;
+      break;
+    case 2:
+      {
+        int16_t narrow = (int16_t) value;
+        memcpy(p, &narrow, sizeof(narrow));
+        break;
+      }
+    case 4:
+      {
+        int32_t narrow = (int32_t) value;
+        memcpy(p, &narrow, sizeof(narrow));
+        break;
+      }
+    default:
+      memcpy(p, &value, sizeof(value));
+      break;
+  }
+}
+
+static void P_SaveVarint(uint64_t value)
+{
+  CheckSaveGame(10);
+
+  while (value >= 0x80)
+  {
+    *save_p++ = (value & 0x7f) | 0x80;
+    value >>= 7;
+  }
+
+  *save_p++ = (byte) value;
+}
+
+static uint64_t P_LoadVarint(void)
+{
+  uint64_t value = 0;
+  int shift = 0;
+
+  do
+  {
+    value |= (uint64_t) (*save_p & 0x7f) << shift;
+    shift += 7;
+  } while (*save_p++ & 0x80);
+
+  return value;
+}
+
+// Stores the subsector as an index, since the pointer changes on reload
+static void P_PrepareArchivedMobj(mobj_t *mobj)
+{
+  mobj->subsector = mobj->subsector ?
+                    (subsector_t *)(intptr_t)(mobj->subsector - subsectors + 1) :
+                    NULL;
+}
+
+static void P_RestoreUnArchivedMobj(mobj_t *mobj)
+{
+  if (mobj->subsector)
+    mobj->subsector = &subsectors[(intptr_t) mobj->subsector - 1];
+}
+
+// Fixed-width fields keep each mobj at a stable offset between key frames,
+// so byte deltas between frames stay small
+static void P_ArchivePackedMobj(mobj_t *mobj)
+{
+  int i;
+
+  P_PrepareArchivedMobj(mobj);
+
+  CheckSaveGame(P_PackedMobjSize());
+
+  for (i = 0; i < MOBJ_FIELD_COUNT; ++i)
+  {
+    memcpy(save_p, (const byte *) mobj + mobj_fields[i].offset, mobj_fields[i].size);
+    save_p += mobj_fields[i].size;
+  }
+}
+
+static void P_UnArchivePackedMobj(mobj_t *mobj)
+{
+  int i;
+
+  memset(mobj, 0, sizeof(*mobj));
+
+  for (i = 0; i < MOBJ_FIELD_COUNT; ++i)
+  {
+    memcpy((byte *) mobj + mobj_fields[i].offset, save_p, mobj_fields[i].size);
+    save_p += mobj_fields[i].size;
+  }
+
+  P_RestoreUnArchivedMobj(mobj);
+}
+
+static void P_ResetCompactBaselines(void)
+{
+  if (compact_baseline_count < num_mobj_types)
+  {
+    compact_baseline_count = num_mobj_types;
+    compact_baselines = Z_Realloc(compact_baselines, compact_baseline_count * sizeof(*compact_baselines));
+    compact_baseline_set = Z_Realloc(compact_baseline_set, compact_baseline_count);
+  }
+
+  memset(compact_baseline_set, 0, compact_baseline_count);
+}
+
+// The first mobj of a type is coded against its spawn defaults
+static mobj_t *P_CompactBaseline(int type)
+{
+  mobj_t *base;
+  mobjinfo_t *info;
+
+  if (type < 0 || type >= num_mobj_types)
+    I_Error("P_CompactBaseline: bad mobj type %d", type);
+
+  base = &compact_baselines[type];
+
+  if (!compact_baseline_set[type])
+  {
+    info = &mobjinfo[type];
+
+    memset(base, 0, sizeof(*base));
+    base->type = type;
+    base->state = (state_t *)(intptr_t) info->spawnstate;
+    base->flags = info->flags;
+    base->flags2 = info->flags2;
+    base->health = info->spawnhealth;
+    base->reactiontime = info->reactiontime;
+    base->radius = info->radius;
+    base->height = info->height;
+
+    compact_baseline_set[type] = true;
+  }
+
+  return base;
+}
+
+// Writes the fields that differ from the baseline as (skip, count, zigzag delta...) runs
+static void P_ArchiveCompactMobj(mobj_t *mobj)
+{
+  mobj_t *base;
+  int i;
+
+  P_PrepareArchivedMobj(mobj);
+
+  base = P_CompactBaseline(mobj->type);
+
+  P_SaveVarint(mobj->type);
+
+  i = 0;
+  while (i < MOBJ_FIELD_COUNT)
+  {
+    int skip, start;
+
+    for (start = i; i < MOBJ_FIELD_COUNT &&
+                    P_GetMobjField(mobj, &mobj_fields[i]) == P_GetMobjField(base, &mobj_fields[i]); ++i);
+    skip = i - start;
+
+    for (start = i; i < MOBJ_FIELD_COUNT &&
+                    P_GetMobjField(mobj, &mobj_fields[i]) != P_GetMobjField(base, &mobj_fields[i]); ++i);
+
+    P_SaveVarint(skip);
+    P_SaveVarint(i - start);
+
+    for (; start < i; ++start)
+    {
+      uint64_t delta;
+
+      delta = (uint64_t) P_GetMobjField(mobj, &mobj_fields[start]) -
+              (uint64_t) P_GetMobjField(base, &mobj_fields[start]);
+
+      P_SaveVarint((delta << 1) ^ (0 - (delta >> 63)));
+      P_SetMobjField(base, &mobj_fields[start], P_GetMobjField(mobj, &mobj_fields[start]));
+    }
+  }
+}
+
+static void P_UnArchiveCompactMobj(mobj_t *mobj)
+{
+  mobj_t *base;
+  int i, j;
+
+  base = P_CompactBaseline((int) P_LoadVarint());
+
+  memset(mobj, 0, sizeof(*mobj));
+
+  i = 0;
+  while (i < MOBJ_FIELD_COUNT)
+  {
+    int skip, count;
+
+    skip = (int) P_LoadVarint();
+    count = (int) P_LoadVarint();
+
+    if ((!skip && !count) || i + skip + count > MOBJ_FIELD_COUNT)
+      I_Error("P_UnArchiveCompactMobj: corrupt mobj data");
+
+    i += skip;
+
+    while (count--)
+    {
+      uint64_t zigzag = P_LoadVarint();
+      uint64_t delta = (zigzag >> 1) ^ (0 - (zigzag & 1));
+
+      P_SetMobjField(base, &mobj_fields[i],
+                     (int64_t) ((uint64_t) P_GetMobjField(base, &mobj_fields[i]) + delta));
+      ++i;
+    }
+  }
+
+  for (j = 0; j < MOBJ_FIELD_COUNT; ++j)
+    P_SetMobjField(mobj, &mobj_fields[j], P_GetMobjField(base, &mobj_fields[j]));
+
+  P_RestoreUnArchivedMobj(mobj);
+}
+
+static void P_SkipCompactMobj(void)
+{
+  int i;
+
+  P_LoadVarint();
+
+  i = 0;
+  while (i < MOBJ_FIELD_COUNT)
+  {
+    int skip, count;
+
+    skip = (int) P_LoadVarint();
+    count = (int) P_LoadVarint();
+
+    if ((!skip && !count) || i + skip + count > MOBJ_FIELD_COUNT)
+      I_Error("P_SkipCompactMobj: corrupt mobj data");
+
+    i += skip + count;
+
+    while (count--)
+      P_LoadVarint();
+  }
+}
+
 // dsda - fix save / load synchronization
 // merges P_ArchiveThinkers & P_ArchiveSpecials
 void P_TrueArchiveThinkers(void) {
@@ -738,6 +1251,21 @@ void P_TrueArchiveThinkers(void) {
 
   P_SAVE_X(brain);
 
+  if (thinker_archive_format != thinker_format_struct)
+  {
+    P_SAVE_BYTE(tc_true_format);
+
+    if (thinker_archive_format == thinker_format_packed)
+    {
+      P_SAVE_BYTE(THINKER_FORMAT_PACKED);
+    }
+    else
+    {
+      P_SAVE_BYTE(THINKER_FORMAT_COMPACT);
+      P_ResetCompactBaselines();
+    }
+  }
+
   // save off the current thinkers
   for (th = thinkercap.next ; th != &thinkercap ; th=th->next) {
     if (!th->function)
@@ -979,9 +1507,17 @@ void P_TrueArchiveThinkers(void) {
     if (P_IsMobjThinker(th))
     {
       mobj_t *mobj;
+      mobj_t coded_mobj;
 
       P_SAVE_BYTE(tc_true_mobj);
-      P_SAVE_TYPE_REF(th, mobj, mobj_t);
+
+      if (thinker_archive_format != thinker_format_struct)
+      {
+        coded_mobj = *(mobj_t *) th;
+        mobj = &coded_mobj;
+      }
+      else
+        P_SAVE_TYPE_REF(th, mobj, mobj_t);
 
       mobj->state = (state_t *)(mobj->state - states);
 
@@ -1019,6 +1555,11 @@ void P_TrueArchiveThinkers(void) {
 
       if (mobj->player)
         mobj->player = (player_t *)((mobj->player-players) + 1);
+
+      if (thinker_archive_format == thinker_format_packed)
+        P_ArchivePackedMobj(mobj);
+      else if (thinker_archive_format == thinker_format_compact)
+        P_ArchiveCompactMobj(mobj);
     }
   }
 
@@ -1053,6 +1594,7 @@ void P_TrueUnArchiveThinkers(void) {
   mobj_t    **mobj_p;    // killough 2/14/98: Translation table
   int    mobj_count;        // killough 2/14/98: size of or index into table
   true_thinkerclass_t tc;
+  thinker_format_t format = thinker_format_struct;
 
   totallive = 0;
 
@@ -1087,7 +1629,36 @@ void P_TrueUnArchiveThinkers(void) {
       if (tc == tc_true_end)
         break;
 
+      if (tc == tc_true_format)
+      {
+        byte id;
+
+        P_LOAD_BYTE(id);
+
+        if (id == THINKER_FORMAT_PACKED)
+          format = thinker_format_packed;
+        else if (id == THINKER_FORMAT_COMPACT)
+          format = thinker_format_compact;
+        else
+          I_Error("P_TrueUnArchiveThinkers: Unknown thinker format %d", id);
+
+        continue;
+      }
+
       if (tc == tc_true_mobj) mobj_count++;
+
+      if (tc == tc_true_mobj && format == thinker_format_compact)
+      {
+        P_SkipCompactMobj();
+        continue;
+      }
+
+      if (tc == tc_true_mobj && format == thinker_format_packed)
+      {
+        save_p += P_PackedMobjSize();
+        continue;
+      }
+
       save_p +=
         tc == tc_true_ceiling        ? sizeof(ceiling_t)       :
         tc == tc_true_door           ? sizeof(vldoor_t)        :
@@ -1125,6 +1696,9 @@ void P_TrueUnArchiveThinkers(void) {
     save_p = sp;           // restore save pointer
   }
 
+  if (format == thinker_format_compact)
+    P_ResetCompactBaselines();
+
   // read in saved thinkers
   mobj_count = 0;
   while (true)
@@ -1134,9 +1708,14 @@ void P_TrueUnArchiveThinkers(void) {
       break;
 
     switch (tc) {
+      case tc_true_format:
+        // checked while counting
+        save_p++;
+        break;
+
       case tc_true_ceiling:
         {
-          ceiling_t *ceiling = Z_MallocLevel (sizeof(*ceiling));
+          ceiling_t *ceiling = Z_PoolMalloc(sizeof(*ceiling));
           P_LOAD_P(ceiling);
           ceiling->sector = &sectors[(size_t)ceiling->sector];
           ceiling->sector->ceilingdata = ceiling; //jff 2/22/98
@@ -1151,7 +1730,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_door:
         {
-          vldoor_t *door = Z_MallocLevel (sizeof(*door));
+          vldoor_t *door = Z_PoolMalloc(sizeof(*door));
           P_LOAD_P(door);
           door->sector = &sectors[(size_t)door->sector];
 
@@ -1166,7 +1745,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_floor:
         {
-          floormove_t *floor = Z_MallocLevel (sizeof(*floor));
+          floormove_t *floor = Z_PoolMalloc(sizeof(*floor));
           P_LOAD_P(floor);
           floor->sector = &sectors[(size_t)floor->sector];
           floor->sector->floordata = floor; //jff 2/22/98
@@ -1177,7 +1756,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_plat:
         {
-          plat_t *plat = Z_MallocLevel (sizeof(*plat));
+          plat_t *plat = Z_PoolMalloc(sizeof(*plat));
           P_LOAD_P(plat);
           plat->sector = &sectors[(size_t)plat->sector];
           plat->sector->floordata = plat; //jff 2/22/98
@@ -1192,7 +1771,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_flash:
         {
-          lightflash_t *flash = Z_MallocLevel (sizeof(*flash));
+          lightflash_t *flash = Z_PoolMalloc(sizeof(*flash));
           P_LOAD_P(flash);
           flash->sector = &sectors[(size_t)flash->sector];
           flash->sector->lightingdata = flash;
@@ -1203,7 +1782,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_strobe:
         {
-          strobe_t *strobe = Z_MallocLevel (sizeof(*strobe));
+          strobe_t *strobe = Z_PoolMalloc(sizeof(*strobe));
           P_LOAD_P(strobe);
           strobe->sector = &sectors[(size_t)strobe->sector];
           strobe->sector->lightingdata = strobe;
@@ -1214,7 +1793,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_glow:
         {
-          glow_t *glow = Z_MallocLevel (sizeof(*glow));
+          glow_t *glow = Z_PoolMalloc(sizeof(*glow));
           P_LOAD_P(glow);
           glow->sector = &sectors[(size_t)glow->sector];
           glow->sector->lightingdata = glow;
@@ -1225,7 +1804,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_zdoom_glow:
         {
-          zdoom_glow_t *glow = Z_MallocLevel (sizeof(*glow));
+          zdoom_glow_t *glow = Z_PoolMalloc(sizeof(*glow));
           P_LOAD_P(glow);
           glow->sector = &sectors[(size_t)glow->sector];
           glow->sector->lightingdata = glow;
@@ -1236,7 +1815,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_flicker:           // killough 10/4/98
         {
-          fireflicker_t *flicker = Z_MallocLevel (sizeof(*flicker));
+          fireflicker_t *flicker = Z_PoolMalloc(sizeof(*flicker));
           P_LOAD_P(flicker);
           flicker->sector = &sectors[(size_t)flicker->sector];
           flicker->sector->lightingdata = flicker;
@@ -1247,7 +1826,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_zdoom_flicker:
         {
-          zdoom_flicker_t *flicker = Z_MallocLevel (sizeof(*flicker));
+          zdoom_flicker_t *flicker = Z_PoolMalloc(sizeof(*flicker));
           P_LOAD_P(flicker);
           flicker->sector = &sectors[(size_t)flicker->sector];
           flicker->sector->lightingdata = flicker;
@@ -1259,7 +1838,7 @@ void P_TrueUnArchiveThinkers(void) {
         //jff 2/22/98 new case for elevators
       case tc_true_elevator:
         {
-          elevator_t *elevator = Z_MallocLevel (sizeof(*elevator));
+          elevator_t *elevator = Z_PoolMalloc(sizeof(*elevator));
           P_LOAD_P(elevator);
           elevator->sector = &sectors[(size_t)elevator->sector];
           elevator->sector->floordata = elevator; //jff 2/22/98
@@ -1271,7 +1850,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_scroll:       // killough 3/7/98: scroll effect thinkers
         {
-          scroll_t *scroll = Z_MallocLevel (sizeof(scroll_t));
+          scroll_t *scroll = Z_PoolMalloc(sizeof(scroll_t));
           P_LOAD_P(scroll);
           scroll->thinker.function = T_Scroll;
           P_AddThinker(&scroll->thinker);
@@ -1280,7 +1859,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_pusher:   // phares 3/22/98: new Push/Pull effect thinkers
         {
-          pusher_t *pusher = Z_MallocLevel (sizeof(pusher_t));
+          pusher_t *pusher = Z_PoolMalloc(sizeof(pusher_t));
           P_LOAD_P(pusher);
           pusher->thinker.function = T_Pusher;
           pusher->source = P_GetPushThing(pusher->affectee);
@@ -1290,7 +1869,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_friction:
         {
-          friction_t *friction = Z_MallocLevel (sizeof(friction_t));
+          friction_t *friction = Z_PoolMalloc(sizeof(friction_t));
           P_LOAD_P(friction);
           friction->thinker.function = T_Friction;
           P_AddThinker(&friction->thinker);
@@ -1299,7 +1878,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_light:
         {
-          light_t *light = Z_MallocLevel(sizeof(*light));
+          light_t *light = Z_PoolMalloc(sizeof(*light));
           P_LOAD_P(light);
           light->sector = &sectors[(size_t)light->sector];
           light->thinker.function = T_Light;
@@ -1309,7 +1888,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_phase:
         {
-          phase_t *phase = Z_MallocLevel(sizeof(*phase));
+          phase_t *phase = Z_PoolMalloc(sizeof(*phase));
           P_LOAD_P(phase);
           phase->sector = &sectors[(size_t)phase->sector];
           phase->sector->lightingdata = phase;
@@ -1320,7 +1899,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_acs:
         {
-          acs_t *acs = Z_MallocLevel(sizeof(*acs));
+          acs_t *acs = Z_PoolMalloc(sizeof(*acs));
           P_LOAD_P(acs);
           acs->line = (intptr_t) acs->line != -1 ? &lines[(size_t) acs->line] : NULL;
           acs->thinker.function = T_InterpretACS;
@@ -1330,7 +1909,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_pillar:
         {
-          pillar_t *pillar = Z_MallocLevel(sizeof(*pillar));
+          pillar_t *pillar = Z_PoolMalloc(sizeof(*pillar));
           P_LOAD_P(pillar);
           pillar->sector = &sectors[(size_t)pillar->sector];
           pillar->sector->floordata = pillar;
@@ -1341,7 +1920,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_floor_waggle:
         {
-          planeWaggle_t *waggle = Z_MallocLevel(sizeof(*waggle));
+          planeWaggle_t *waggle = Z_PoolMalloc(sizeof(*waggle));
           P_LOAD_P(waggle);
           waggle->sector = &sectors[(size_t)waggle->sector];
           waggle->sector->floordata = waggle;
@@ -1352,7 +1931,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_ceiling_waggle:
         {
-          planeWaggle_t *waggle = Z_MallocLevel(sizeof(*waggle));
+          planeWaggle_t *waggle = Z_PoolMalloc(sizeof(*waggle));
           P_LOAD_P(waggle);
           waggle->sector = &sectors[(size_t)waggle->sector];
           waggle->sector->floordata = waggle;
@@ -1363,7 +1942,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_poly_rotate:
         {
-          polyevent_t *poly = Z_MallocLevel(sizeof(*poly));
+          polyevent_t *poly = Z_PoolMalloc(sizeof(*poly));
           P_LOAD_P(poly);
           poly->thinker.function = T_RotatePoly;
           P_AddThinker(&poly->thinker);
@@ -1372,7 +1951,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_poly_move:
         {
-          polyevent_t *poly = Z_MallocLevel(sizeof(*poly));
+          polyevent_t *poly = Z_PoolMalloc(sizeof(*poly));
           P_LOAD_P(poly);
           poly->thinker.function = T_MovePoly;
           P_AddThinker(&poly->thinker);
@@ -1381,7 +1960,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_poly_door:
         {
-          polydoor_t *poly = Z_MallocLevel(sizeof(*poly));
+          polydoor_t *poly = Z_PoolMalloc(sizeof(*poly));
           P_LOAD_P(poly);
           poly->thinker.function = T_PolyDoor;
           P_AddThinker(&poly->thinker);
@@ -1390,7 +1969,7 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_quake:
         {
-          quake_t *quake = Z_MallocLevel(sizeof(*quake));
+          quake_t *quake = Z_PoolMalloc(sizeof(*quake));
           P_LOAD_P(quake);
           quake->thinker.function = dsda_UpdateQuake;
           P_AddThinker(&quake->thinker);
@@ -1399,13 +1978,18 @@ void P_TrueUnArchiveThinkers(void) {
 
       case tc_true_mobj:
         {
-          mobj_t *mobj = Z_MallocLevel(sizeof(mobj_t));
+          mobj_t *mobj = Z_PoolMalloc(sizeof(mobj_t));
 
           // killough 2/14/98 -- insert pointers to thinkers into table, in order:
           mobj_count++;
           mobj_p[mobj_count] = mobj;
 
-          P_LOAD_P(mobj);
+          if (format == thinker_format_packed)
+            P_UnArchivePackedMobj(mobj);
+          else if (format == thinker_format_compact)
+            P_UnArchiveCompactMobj(mobj);
+          else
+            P_LOAD_P(mobj);
 
           mobj->state = states + (intptr_t) mobj->state;
 
@@ -1503,6 +2087,7 @@ void P_TrueUnArchiveThinkers(void) {
   }
 
   P_UnArchiveBlockLinks(mobj_p, mobj_count);
+  P_ResetThingIndex();
   P_UnArchiveThinkerSubclasses(mobj_p, mobj_count);
 
   dsda_UnArchiveMSecNodes(mobj_p, mobj_count);
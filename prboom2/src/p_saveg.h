@@ -36,7 +36,7 @@
 
 #include "doomtype.h"
 
-#define SAVEVERSION 2
+#define SAVEVERSION 3
 
 /* Persistent storage/archiving.
  * These are the load / save game routines. */
@@ -55,6 +55,14 @@ void P_UnArchiveRNG(void);
 void P_ArchiveMap(void);
 void P_UnArchiveMap(void);
 
+typedef enum {
+  thinker_format_struct,
+  thinker_format_packed,  // mobj fields at fixed widths, without links or padding
+  thinker_format_compact, // mobjs coded field-wise against the previous one of their type
+} thinker_format_t;
+
+extern thinker_format_t thinker_archive_format;
+
 // dsda - fix save / load synchronization
 void P_TrueArchiveThinkers(void);
 void P_TrueUnArchiveThinkers(void);
@@ -66,6 +74,9 @@ void CheckSaveGame(size_t size);
 void P_InitSaveBuffer(void);
 void P_ForgetSaveBuffer(void);
 void P_FreeSaveBuffer(void);
+void P_ReleaseSaveBuffer(byte *buffer, size_t size);
+size_t P_SaveBufferSize(void);
+size_t P_SaveBufferPoolSize(void);
 
 #define P_SAVE_X(x) { CheckSaveGame(sizeof(x)); \
                       memcpy(save_p, &x, sizeof(x)); \
@@ -59,6 +59,7 @@
 
 #include "dsda.h"
 #include "dsda/args.h"
+#include "dsda/blockmap.h"
 #include "dsda/compatibility.h"
 #include "dsda/destructible.h"
 #include "dsda/id_list.h"
@@ -68,6 +69,8 @@
 #include "dsda/preferences.h"
 #include "dsda/settings.h"
 #include "dsda/skip.h"
+#include "dsda/thread_pool.h"
+#include "dsda/time.h"
 #include "dsda/tranmap.h"
 #include "dsda/udmf.h"
 #include "dsda/utility.h"
@@ -1176,54 +1179,151 @@ static void CheckZNodesOverflow(int *size, int count)
   }
 }
 
-static byte *P_DecompressData(const byte **data, int *len)
+//
+// ZNODES inflation
+//
+// Compressed nodes only depend on the lump, so P_SetupLevel starts
+// inflating them on a worker thread while the rest of the map loads.
+// The worker uses malloc and reports errors back instead of calling I_Error.
+//
+
+typedef struct
+{
+  const byte *data;
+  int len;
+  byte *output;
+  int outlen;
+  const char *error;
+  int task;
+  dboolean started;
+} znodes_inflate_t;
+
+static znodes_inflate_t znodes_inflate;
+
+static void P_InflateZNodes(void *data)
 {
+  znodes_inflate_t *zi = data;
   byte *output;
   int outlen, err;
-  z_stream *zstream;
+  z_stream zstream;
   union
   {
     const byte* cd;
     byte* d;
-  } u = { *data };
+  } u = { zi->data };
 
   // first estimate for compression rate:
   // output buffer size == 2.5 * input size
-  outlen = 2.5 * *len;
-  output = Z_Malloc(outlen);
+  outlen = 2.5 * zi->len;
+  output = malloc(outlen);
+  zi->output = output;
+
+  if (!output && outlen)
+  {
+    zi->error = "Out of memory!";
+    return;
+  }
 
   // initialize stream state for decompression
-  zstream = Z_Malloc(sizeof(*zstream));
-  memset(zstream, 0, sizeof(*zstream));
+  memset(&zstream, 0, sizeof(zstream));
 
-  zstream->next_in = u.d;
-  zstream->avail_in = *len;
-  zstream->next_out = output;
-  zstream->avail_out = outlen;
+  zstream.next_in = u.d;
+  zstream.avail_in = zi->len;
+  zstream.next_out = output;
+  zstream.avail_out = outlen;
 
-  if (inflateInit(zstream) != Z_OK)
-      I_Error("P_DecompressData: Error during decompression initialization!");
+  if (inflateInit(&zstream) != Z_OK)
+  {
+    zi->error = "Error during decompression initialization!";
+    return;
+  }
 
   // resize if output buffer runs full
-  while ((err = inflate(zstream, Z_SYNC_FLUSH)) == Z_OK)
+  while ((err = inflate(&zstream, Z_SYNC_FLUSH)) == Z_OK)
   {
-      int outlen_old = outlen;
-      outlen = 2 * outlen_old;
-      output = Z_Realloc(output, outlen);
-      zstream->next_out = output + outlen_old;
-      zstream->avail_out = outlen - outlen_old;
+    int outlen_old = outlen;
+    outlen = 2 * outlen_old;
+    output = realloc(output, outlen);
+
+    if (!output)
+    {
+      zi->error = "Out of memory!";
+      inflateEnd(&zstream);
+      return;
+    }
+
+    zi->output = output;
+    zstream.next_out = output + outlen_old;
+    zstream.avail_out = outlen - outlen_old;
   }
 
+  zi->outlen = zstream.total_out;
+
   if (err != Z_STREAM_END)
-      I_Error("P_DecompressData: Error during decompression!");
+  {
+    zi->error = "Error during decompression!";
+    inflateEnd(&zstream);
+    return;
+  }
 
-  *data = output;
-  *len = zstream->total_out;
+  if (inflateEnd(&zstream) != Z_OK)
+    zi->error = "Error during decompression shut-down!";
+}
+
+static void P_StartZNodesInflate(void)
+{
+  int lump;
+
+  switch (nodesVersion)
+  {
+    case ZDOOM_ZNOD_NODES:
+      lump = level_components.nodes;
+      break;
+    case ZDOOM_ZGLN_NODES:
+    case ZDOOM_ZGL2_NODES:
+    case ZDOOM_ZGL3_NODES:
+      lump = level_components.znodes;
+      break;
+    default:
+      return;
+  }
+
+  // leave short lumps to the overflow checks in P_LoadZNodes
+  if (W_LumpLength(lump) < 4)
+    return;
+
+  memset(&znodes_inflate, 0, sizeof(znodes_inflate));
+  znodes_inflate.data = (const byte *) W_LumpByNum(lump) + 4;
+  znodes_inflate.len = W_LumpLength(lump) - 4;
+  znodes_inflate.started = true;
+  znodes_inflate.task = dsda_QueueTask(P_InflateZNodes, &znodes_inflate);
+}
+
+// The returned buffer belongs to the caller, who must release it with free
+static byte *P_DecompressData(const byte **data, int *len)
+{
+  byte *output;
+
+  if (znodes_inflate.started && znodes_inflate.data == *data)
+  {
+    dsda_FinishTask(znodes_inflate.task);
+  }
+  else
+  {
+    memset(&znodes_inflate, 0, sizeof(znodes_inflate));
+    znodes_inflate.data = *data;
+    znodes_inflate.len = *len;
+    P_InflateZNodes(&znodes_inflate);
+  }
+
+  if (znodes_inflate.error)
+    I_Error("P_DecompressData: %s", znodes_inflate.error);
 
-  if (inflateEnd(zstream) != Z_OK)
-      I_Error("P_DecompressData: Error during decompression shut-down!");
+  output = znodes_inflate.output;
+  *data = output;
+  *len = znodes_inflate.outlen;
 
-  Z_Free(zstream);
+  memset(&znodes_inflate, 0, sizeof(znodes_inflate));
 
   return output;
 }
@@ -1616,7 +1716,7 @@ static void P_LoadZNodes(int lump, int glnodes)
   }
 
   if (output)
-    Z_Free(output);
+    free(output);
 }
 
 static int no_overlapped_sprites;
@@ -2566,51 +2666,6 @@ static void P_LoadUDMFSideDefs(int lump)
   }
 }
 
-//
-// jff 10/6/98
-// New code added to speed up calculation of internal blockmap
-// Algorithm is order of nlines*(ncols+nrows) not nlines*ncols*nrows
-//
-
-#define blkshift 7               /* places to shift rel position for cell num */
-#define blkmask ((1<<blkshift)-1)/* mask for rel position within cell */
-#define blkmargin 0              /* size guardband around map used */
-                                 // jff 10/8/98 use guardband>0
-                                 // jff 10/12/98 0 ok with + 1 in rows,cols
-
-typedef struct linelist_t        // type used to list lines in each block
-{
-  long num;
-  struct linelist_t *next;
-} linelist_t;
-
-//
-// Subroutine to add a line number to a block list
-// It simply returns if the line is already in the block
-//
-
-static void AddBlockLine
-(
-  linelist_t **lists,
-  int *count,
-  int *done,
-  int blockno,
-  long lineno
-)
-{
-  linelist_t *l;
-
-  if (done[blockno])
-    return;
-
-  l = Z_Malloc(sizeof(linelist_t));
-  l->num = lineno;
-  l->next = lists[blockno];
-  lists[blockno] = l;
-  count[blockno]++;
-  done[blockno] = 1;
-}
-
 blockmap_t original_blockmap;
 
 static void RememberOriginalBlockMap(void)
@@ -2632,280 +2687,29 @@ void P_RestoreOriginalBlockMap(void)
 //
 // Actually construct the blockmap lump from the level data
 //
-// This finds the intersection of each linedef with the column and
-// row lines at the left and bottom of each blockmap cell. It then
-// adds the line to all block lists touching the intersection.
+// The lists are built by dsda_CreateBlockMap, which bins lines across
+// threads and caches large results on disk
 //
 
 static void P_CreateBlockMap(void)
 {
-  int xorg,yorg;                 // blockmap origin (lower left)
-  int nrows,ncols;               // blockmap dimensions
-  linelist_t **blocklists=NULL;  // array of pointers to lists of lines
-  int *blockcount=NULL;          // array of counters of line lists
-  int *blockdone=NULL;           // array keeping track of blocks/line
-  int NBlocks;                   // number of cells = nrows*ncols
-  long linetotal=0;              // total length of all blocklists
-  int i,j;
-  int map_minx=INT_MAX;          // init for map limits search
-  int map_miny=INT_MAX;
-  int map_maxx=INT_MIN;
-  int map_maxy=INT_MIN;
-
-  // scan for map limits, which the blockmap must enclose
-
-  // This fixes MBF's code, which has a bug where maxx/maxy
-  // are wrong if the 0th node has the largest x or y
-  if (numvertexes)
-  {
-    map_minx = map_maxx = vertexes[0].x;
-    map_miny = map_maxy = vertexes[0].y;
-  }
-
-  for (i=0;i<numvertexes;i++)
-  {
-    fixed_t t;
-
-    if ((t=vertexes[i].x) < map_minx)
-      map_minx = t;
-    else if (t > map_maxx)
-      map_maxx = t;
-    if ((t=vertexes[i].y) < map_miny)
-      map_miny = t;
-    else if (t > map_maxy)
-      map_maxy = t;
-  }
-  map_minx >>= FRACBITS;    // work in map coords, not fixed_t
-  map_maxx >>= FRACBITS;
-  map_miny >>= FRACBITS;
-  map_maxy >>= FRACBITS;
-
-  // set up blockmap area to enclose level plus margin
-
-  xorg = map_minx-blkmargin;
-  yorg = map_miny-blkmargin;
-  ncols = (map_maxx+blkmargin-xorg+1+blkmask)>>blkshift;  //jff 10/12/98
-  nrows = (map_maxy+blkmargin-yorg+1+blkmask)>>blkshift;  //+1 needed for
-  NBlocks = ncols*nrows;                                  //map exactly 1 cell
-
-  // create the array of pointers on NBlocks to blocklists
-  // also create an array of linelist counts on NBlocks
-  // finally make an array in which we can mark blocks done per line
-
-  // CPhipps - calloc's
-  blocklists = Z_Calloc(NBlocks,sizeof(linelist_t *));
-  blockcount = Z_Calloc(NBlocks,sizeof(int));
-  blockdone = Z_Malloc(NBlocks*sizeof(int));
-
-  // initialize each blocklist, and enter the trailing -1 in all blocklists
-  // note the linked list of lines grows backwards
-
-  for (i=0;i<NBlocks;i++)
-  {
-    blocklists[i] = Z_Malloc(sizeof(linelist_t));
-    blocklists[i]->num = -1;
-    blocklists[i]->next = NULL;
-    blockcount[i]++;
-  }
-
-  // For each linedef in the wad, determine all blockmap blocks it touches,
-  // and add the linedef number to the blocklists for those blocks
-
-  for (i=0;i<numlines;i++)
-  {
-    int x1 = lines[i].v1->x>>FRACBITS;         // lines[i] map coords
-    int y1 = lines[i].v1->y>>FRACBITS;
-    int x2 = lines[i].v2->x>>FRACBITS;
-    int y2 = lines[i].v2->y>>FRACBITS;
-    int dx = x2-x1;
-    int dy = y2-y1;
-    int vert = !dx;                            // lines[i] slopetype
-    int horiz = !dy;
-    int spos = (dx^dy) > 0;
-    int sneg = (dx^dy) < 0;
-    int bx,by;                                 // block cell coords
-    int minx = x1>x2? x2 : x1;                 // extremal lines[i] coords
-    int maxx = x1>x2? x1 : x2;
-    int miny = y1>y2? y2 : y1;
-    int maxy = y1>y2? y1 : y2;
-
-    // no blocks done for this linedef yet
-
-    memset(blockdone,0,NBlocks*sizeof(int));
-
-    // The line always belongs to the blocks containing its endpoints
-
-    bx = (x1-xorg)>>blkshift;
-    by = (y1-yorg)>>blkshift;
-    AddBlockLine(blocklists,blockcount,blockdone,by*ncols+bx,i);
-    bx = (x2-xorg)>>blkshift;
-    by = (y2-yorg)>>blkshift;
-    AddBlockLine(blocklists,blockcount,blockdone,by*ncols+bx,i);
-
+  int count;
+  int *buffer;
 
-    // For each column, see where the line along its left edge, which
-    // it contains, intersects the Linedef i. Add i to each corresponding
-    // blocklist.
+  buffer = dsda_CreateBlockMap(&count);
 
-    if (!vert)    // don't interesect vertical lines with columns
-    {
-      for (j=0;j<ncols;j++)
-      {
-        // intersection of Linedef with x=xorg+(j<<blkshift)
-        // (y-y1)*dx = dy*(x-x1)
-        // y = dy*(x-x1)+y1*dx;
-
-        int x = xorg+(j<<blkshift);       // (x,y) is intersection
-        int y = (dy*(x-x1))/dx+y1;
-        int yb = (y-yorg)>>blkshift;      // block row number
-        int yp = (y-yorg)&blkmask;        // y position within block
-
-        if (yb<0 || yb>nrows-1)     // outside blockmap, continue
-          continue;
-
-        if (x<minx || x>maxx)       // line doesn't touch column
-          continue;
-
-        // The cell that contains the intersection point is always added
-
-        AddBlockLine(blocklists,blockcount,blockdone,ncols*yb+j,i);
-
-        // if the intersection is at a corner it depends on the slope
-        // (and whether the line extends past the intersection) which
-        // blocks are hit
-
-        if (yp==0)        // intersection at a corner
-        {
-          if (sneg)       //   \ - blocks x,y-, x-,y
-          {
-            if (yb>0 && miny<y)
-              AddBlockLine(blocklists,blockcount,blockdone,ncols*(yb-1)+j,i);
-            if (j>0 && minx<x)
-              AddBlockLine(blocklists,blockcount,blockdone,ncols*yb+j-1,i);
-          }
-          else if (spos)  //   / - block x-,y-
-          {
-            if (yb>0 && j>0 && minx<x)
-              AddBlockLine(blocklists,blockcount,blockdone,ncols*(yb-1)+j-1,i);
-          }
-          else if (horiz) //   - - block x-,y
-          {
-            if (j>0 && minx<x)
-              AddBlockLine(blocklists,blockcount,blockdone,ncols*yb+j-1,i);
-          }
-        }
-        else if (j>0 && minx<x) // else not at corner: x-,y
-          AddBlockLine(blocklists,blockcount,blockdone,ncols*yb+j-1,i);
-      }
-    }
-
-    // For each row, see where the line along its bottom edge, which
-    // it contains, intersects the Linedef i. Add i to all the corresponding
-    // blocklists.
-
-    if (!horiz)
-    {
-      for (j=0;j<nrows;j++)
-      {
-        // intersection of Linedef with y=yorg+(j<<blkshift)
-        // (x,y) on Linedef i satisfies: (y-y1)*dx = dy*(x-x1)
-        // x = dx*(y-y1)/dy+x1;
-
-        int y = yorg+(j<<blkshift);       // (x,y) is intersection
-        int x = (dx*(y-y1))/dy+x1;
-        int xb = (x-xorg)>>blkshift;      // block column number
-        int xp = (x-xorg)&blkmask;        // x position within block
+  blockmaplump = malloc_IfSameLevel(blockmaplump, sizeof(*blockmaplump) * count);
+  memcpy(blockmaplump, buffer, sizeof(*blockmaplump) * count);
+  Z_Free(buffer);
 
-        if (xb<0 || xb>ncols-1)   // outside blockmap, continue
-          continue;
-
-        if (y<miny || y>maxy)     // line doesn't touch row
-          continue;
-
-        // The cell that contains the intersection point is always added
-
-        AddBlockLine(blocklists,blockcount,blockdone,ncols*j+xb,i);
-
-        // if the intersection is at a corner it depends on the slope
-        // (and whether the line extends past the intersection) which
-        // blocks are hit
-
-        if (xp==0)        // intersection at a corner
-        {
-          if (sneg)       //   \ - blocks x,y-, x-,y
-          {
-            if (j>0 && miny<y)
-              AddBlockLine(blocklists,blockcount,blockdone,ncols*(j-1)+xb,i);
-            if (xb>0 && minx<x)
-              AddBlockLine(blocklists,blockcount,blockdone,ncols*j+xb-1,i);
-          }
-          else if (vert)  //   | - block x,y-
-          {
-            if (j>0 && miny<y)
-              AddBlockLine(blocklists,blockcount,blockdone,ncols*(j-1)+xb,i);
-          }
-          else if (spos)  //   / - block x-,y-
-          {
-            if (xb>0 && j>0 && miny<y)
-              AddBlockLine(blocklists,blockcount,blockdone,ncols*(j-1)+xb-1,i);
-          }
-        }
-        else if (j>0 && miny<y) // else not on a corner: x,y-
-          AddBlockLine(blocklists,blockcount,blockdone,ncols*(j-1)+xb,i);
-      }
-    }
-  }
-
-  // Add initial 0 to all blocklists
-  // count the total number of lines (and 0's and -1's)
-
-  memset(blockdone,0,NBlocks*sizeof(int));
-  for (i=0,linetotal=0;i<NBlocks;i++)
-  {
-    AddBlockLine(blocklists,blockcount,blockdone,i,0);
-    linetotal += blockcount[i];
-  }
-
-  // Create the blockmap lump
-
-  blockmaplump = malloc_IfSameLevel(blockmaplump, sizeof(*blockmaplump) * (4 + NBlocks + linetotal));
   // blockmap header
 
-  blockmaplump[0] = bmaporgx = xorg << FRACBITS;
-  blockmaplump[1] = bmaporgy = yorg << FRACBITS;
-  blockmaplump[2] = bmapwidth  = ncols;
-  blockmaplump[3] = bmapheight = nrows;
-
-  // offsets to lists and block lists
-
-  for (i=0;i<NBlocks;i++)
-  {
-    linelist_t *bl = blocklists[i];
-    long offs = blockmaplump[4+i] =   // set offset to block's list
-      (i? blockmaplump[4+i-1] : 4+NBlocks) + (i? blockcount[i-1] : 0);
-
-    // add the lines in each block's list to the blockmaplump
-    // delete each list node as we go
-
-    while (bl)
-    {
-      linelist_t *tmp = bl->next;
-      blockmaplump[offs++] = bl->num;
-      Z_Free(bl);
-      bl = tmp;
-    }
-  }
-
-  // free all temporary storage
-
-  Z_Free (blocklists);
-  Z_Free (blockcount);
-  Z_Free (blockdone);
+  bmaporgx = blockmaplump[0];
+  bmaporgy = blockmaplump[1];
+  bmapwidth = blockmaplump[2];
+  bmapheight = blockmaplump[3];
 }
 
-// jff 10/6/98
-// End new code added to speed up calculation of internal blockmap
-
 //
 // P_VerifyBlockMap
 //
@@ -3672,6 +3476,55 @@ void P_MustRebuildBlockmap(void)
   must_rebuild_blockmap = true;
 }
 
+//
+// Level load timing
+//
+// -timelevelload reports how long each stage of P_SetupLevel takes,
+// to find the bottlenecks in transitions to very large maps.
+//
+
+static int time_level_load = -1;
+static unsigned long long level_load_total;
+
+static void P_StartLevelLoadTimer(const char *lumpname)
+{
+  if (time_level_load < 0)
+    time_level_load = dsda_Flag(dsda_arg_timelevelload);
+
+  if (!time_level_load)
+    return;
+
+  lprintf(LO_INFO, "P_SetupLevel: %s (%d threads)\n", lumpname, dsda_ThreadCount());
+
+  level_load_total = 0;
+  dsda_StartTimer(dsda_timer_level_load);
+}
+
+static void P_LevelLoadStage(const char *stage)
+{
+  unsigned long long elapsed;
+
+  if (!time_level_load)
+    return;
+
+  elapsed = dsda_ElapsedTime(dsda_timer_level_load);
+  level_load_total += elapsed;
+
+  lprintf(LO_INFO, "  %-16s %8.3f ms\n", stage, (double) elapsed / 1000);
+
+  dsda_StartTimer(dsda_timer_level_load);
+}
+
+static void P_EndLevelLoadTimer(void)
+{
+  if (!time_level_load)
+    return;
+
+  P_LevelLoadStage("finish");
+
+  lprintf(LO_INFO, "  %-16s %8.3f ms\n", "total", (double) level_load_total / 1000);
+}
+
 //
 // P_SetupLevel
 //
@@ -3711,8 +3564,12 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
 
   Z_FreeLevel();
 
+  P_ResetLevelPeaks();
+
   P_InitThinkers();
 
+  P_ClearSightCache();
+
   // if working with a devlopment map, reload it
   //    W_Reload ();     killough 1/31/98: W_Reload obsolete
 
@@ -3720,6 +3577,8 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
   strcpy(lumpname, MAPNAME(episode, map));
   lumpnum = W_GetNumForName(lumpname);
 
+  P_StartLevelLoadTimer(lumpname);
+
   if (strlen(lumpname) < 6)
   {
     snprintf(gl_lumpname, sizeof(gl_lumpname), "GL_%s", lumpname);
@@ -3758,6 +3617,9 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
   current_map = map;
   current_nodesVersion = nodesVersion;
 
+  // Compressed nodes inflate on a worker while the map geometry loads
+  P_StartZNodesInflate();
+
   dsda_WatchNewLevel();
 
   if (!samelevel)
@@ -3781,14 +3643,26 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
 
   dsda_ResetHealthGroups();
 
+  P_LevelLoadStage("prepare");
+
   map_loader.load_vertexes(level_components.vertexes, level_components.gl_verts);
+  P_LevelLoadStage("vertexes");
+
   map_loader.load_sectors(level_components.sectors);
+  P_LevelLoadStage("sectors");
+
   map_loader.allocate_sidedefs(level_components.sidedefs);
   map_loader.load_linedefs(level_components.linedefs);
+  P_LevelLoadStage("linedefs");
+
   map_loader.load_sidedefs(level_components.sidedefs);
+  P_LevelLoadStage("sidedefs");
 
   P_PostProcessLineDefs();
 
+  P_ReserveIntercepts(numlines + MAXINTERCEPTS_ORIGINAL);
+  P_ReserveSpecHits(numlines);
+
   // e6y: speedup of level reloading
   // Do not reload BlockMap for same level,
   // because in case of big level P_CreateBlockMap eats much time
@@ -3805,6 +3679,10 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
     memset(blocklinks, 0, bmapwidth*bmapheight*sizeof(*blocklinks));
   }
 
+  P_InitThingIndex();
+
+  P_LevelLoadStage("blockmap");
+
   switch (nodesVersion)
   {
     case GL_V1_NODES:
@@ -3855,6 +3733,8 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
       break;
   }
 
+  P_LevelLoadStage("nodes");
+
   if (!samelevel)
   {
     P_InitSubsectorsLines();
@@ -3865,11 +3745,14 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
 
   // reject loading and underflow padding separated out into new function
   P_LoadReject(level_components.reject);
+  P_LevelLoadStage("group lines");
 
   P_RemoveSlimeTrails();    // killough 10/98: remove slime trails from wad
+  P_LevelLoadStage("slime trails");
 
   // should be after P_RemoveSlimeTrails, because it changes vertexes
   R_CalcSegsLength();
+  P_LevelLoadStage("seg lengths");
 
   {
     void A_ResetPlayerCorpseQueue(void);
@@ -3900,6 +3783,7 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
   }
 
   map_loader.load_things(level_components.things);
+  P_LevelLoadStage("things");
 
   if (map_format.polyobjs)
   {
@@ -3955,6 +3839,7 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
 
   // set up world state
   P_SpawnSpecials();
+  P_LevelLoadStage("specials");
 
   dsda_WatchAfterLevelSetup();
 
@@ -3966,6 +3851,7 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
 
   // preload graphics
   R_PrecacheLevel();
+  P_LevelLoadStage("precache");
 
   if (V_IsOpenGLMode())
   {
@@ -3995,6 +3881,8 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
   {
     AM_Start(false);
   }
+
+  P_EndLevelLoadTimer();
 }
 
 //
@@ -49,6 +49,7 @@ extern int      bmapheight;      /* in mapblocks */
 extern fixed_t  bmaporgx;
 extern fixed_t  bmaporgy;        /* origin of block map */
 extern mobj_t   **blocklinks;    /* for thing chains */
+extern int      blocklinks_count;
 
 extern dboolean skipblstart; // MaxW: Skip initial blocklist short
 
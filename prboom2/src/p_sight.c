@@ -42,6 +42,7 @@
 #include "g_overflow.h"
 #include "e6y.h" //e6y
 
+#include "dsda/args.h"
 #include "dsda/map_format.h"
 
 /*
@@ -897,7 +898,7 @@ static dboolean P_CrossBSPNode(int bspnum)
 //
 // killough 4/20/98: cleaned up, made to use new LOS struct
 
-dboolean P_CheckSight(mobj_t *t1, mobj_t *t2)
+static dboolean P_CheckSightUncached(mobj_t *t1, mobj_t *t2)
 {
   const sector_t *s1, *s2;
   int pnum;
@@ -984,6 +985,114 @@ dboolean P_CheckSight(mobj_t *t1, mobj_t *t2)
   return P_CrossBSPNode(numnodes-1);
 }
 
+//
+// Sight cache
+//
+// A sight check depends only on where the two things are and on the
+// sector heights, so repeated checks in a tic can reuse the result.
+// The key holds both positions, which covers every move through
+// P_SetThingPosition; anything that moves a sector clears the cache.
+//
+
+#define SIGHT_CACHE_SIZE 1024
+#define SIGHT_CACHE_PROBES 4
+
+typedef struct
+{
+  unsigned int stamp;
+  dboolean result;
+  const subsector_t *subsector[2];
+  fixed_t x[2], y[2], z[2], height[2];
+} sight_cache_t;
+
+static sight_cache_t sight_cache[SIGHT_CACHE_SIZE];
+static unsigned int sight_cache_stamp = 1;
+static int sight_cache_enabled = -1;
+
+int sight_cache_hits;
+int sight_cache_misses;
+int sight_cache_clears;
+
+void P_ClearSightCache(void)
+{
+  if (sight_cache_enabled != 1)
+    return;
+
+  ++sight_cache_clears;
+
+  if (!++sight_cache_stamp)
+  {
+    memset(sight_cache, 0, sizeof(sight_cache));
+    sight_cache_stamp = 1;
+  }
+}
+
+static dboolean P_SightCacheMatch(const sight_cache_t *entry, const mobj_t *t1, const mobj_t *t2)
+{
+  return entry->stamp == sight_cache_stamp &&
+         entry->subsector[0] == t1->subsector && entry->subsector[1] == t2->subsector &&
+         entry->x[0] == t1->x && entry->x[1] == t2->x &&
+         entry->y[0] == t1->y && entry->y[1] == t2->y &&
+         entry->z[0] == t1->z && entry->z[1] == t2->z &&
+         entry->height[0] == t1->height && entry->height[1] == t2->height;
+}
+
+dboolean P_CheckSight(mobj_t *t1, mobj_t *t2)
+{
+  sight_cache_t *entry;
+  unsigned int hash;
+  int i;
+
+  if (sight_cache_enabled < 0)
+    sight_cache_enabled = dsda_Flag(dsda_arg_sight_cache);
+
+  // Polyobjects move lines without moving sectors
+  if (!sight_cache_enabled || map_format.polyobjs)
+    return P_CheckSightUncached(t1, t2);
+
+  hash = (unsigned int) (t1->x ^ t1->y) * 2654435761u +
+         (unsigned int) (t2->x ^ t2->y ^ t2->z) * 40503u;
+
+  for (i = 0; i < SIGHT_CACHE_PROBES; ++i)
+  {
+    entry = &sight_cache[(hash + i) & (SIGHT_CACHE_SIZE - 1)];
+
+    if (P_SightCacheMatch(entry, t1, t2))
+    {
+      ++sight_cache_hits;
+      return entry->result;
+    }
+  }
+
+  ++sight_cache_misses;
+
+  for (i = 0; i < SIGHT_CACHE_PROBES; ++i)
+  {
+    entry = &sight_cache[(hash + i) & (SIGHT_CACHE_SIZE - 1)];
+
+    if (entry->stamp != sight_cache_stamp)
+      break;
+  }
+
+  if (i == SIGHT_CACHE_PROBES)
+    entry = &sight_cache[hash & (SIGHT_CACHE_SIZE - 1)];
+
+  entry->stamp = sight_cache_stamp;
+  entry->subsector[0] = t1->subsector;
+  entry->subsector[1] = t2->subsector;
+  entry->x[0] = t1->x;
+  entry->x[1] = t2->x;
+  entry->y[0] = t1->y;
+  entry->y[1] = t2->y;
+  entry->z[0] = t1->z;
+  entry->z[1] = t2->z;
+  entry->height[0] = t1->height;
+  entry->height[1] = t2->height;
+  entry->result = P_CheckSightUncached(t1, t2);
+
+  return entry->result;
+}
+
 //
 // P_CheckFov
 // Returns true if t2 is within t1's field of view.
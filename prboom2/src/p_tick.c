@@ -327,6 +327,8 @@ void P_Ticker (void)
 
   R_UpdateInterpolations ();
 
+  P_ClearSightCache();
+
   if (dsda_FrozenMode())
   {
     P_FrozenTicker();
@@ -35,17 +35,28 @@
 
 #include <stdint.h>
 
+#include "SDL_cpuinfo.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define R_DRAWSPAN_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "doomstat.h"
 #include "w_wad.h"
 #include "r_main.h"
 #include "r_draw.h"
+#include "r_plane.h"
 #include "v_video.h"
 #include "st_stuff.h"
 #include "g_game.h"
 #include "am_map.h"
 #include "lprintf.h"
+#include "i_system.h"
 
+#include "dsda/args.h"
 #include "dsda/stretch.h"
+#include "dsda/time.h"
 
 //
 // All drawing to the view buffer is accomplished in this file.
@@ -128,6 +139,8 @@ static int fuzzpos = 0;
 #define RDC_FUZZ          8
 // no color mapping
 #define RDC_NOCOLMAP     16
+// write straight to the frame buffer instead of the column buffer
+#define RDC_UNBUFFERED   32
 
 draw_vars_t drawvars = {
   NULL, // topleft
@@ -336,6 +349,61 @@ R_DrawColumn_f R_GetDrawColumnFunc(enum column_pipeline_e type, enum draw_filter
   return result;
 }
 
+//
+// Sliced rendering
+//
+// The column buffer above is shared, so columns drawn from several
+// threads at once go straight to the frame buffer. For opaque columns
+// the result is the same pixels the buffered path writes.
+//
+
+#define R_DRAWCOLUMN_FUNCNAME R_DrawColumnUnbuffered
+#define R_DRAWCOLUMN_PIPELINE (RDC_STANDARD | RDC_UNBUFFERED)
+#include "r_drawcolumn.inl"
+
+R_DrawColumn_f R_GetUnbufferedColumnFunc(void) {
+  return R_DrawColumnUnbuffered;
+}
+
+// Opaque wall columns recorded during the bsp walk, kept apart by the
+// slice they fall in and replayed by that slice in recording order
+typedef struct {
+  draw_column_vars_t *columns;
+  int count;
+  int size;
+} deferred_slice_t;
+
+static deferred_slice_t deferred_slices[MAX_RENDER_SLICES];
+
+void R_DeferColumn(draw_column_vars_t *dcvars) {
+  deferred_slice_t *slice;
+
+  // Slice i covers viewwidth * i / render_slices up to the next boundary
+  slice = &deferred_slices[((dcvars->x + 1) * render_slices - 1) / viewwidth];
+
+  if (slice->count == slice->size) {
+    slice->size = slice->size ? slice->size * 2 : 1024;
+    slice->columns = Z_Realloc(slice->columns, slice->size * sizeof(*slice->columns));
+  }
+
+  slice->columns[slice->count++] = *dcvars;
+}
+
+void R_DrawDeferredColumns(int index) {
+  deferred_slice_t *slice = &deferred_slices[index];
+  int i;
+
+  for (i = 0; i < slice->count; i++)
+    R_DrawColumnUnbuffered(&slice->columns[i]);
+}
+
+void R_ClearDeferredColumns(void) {
+  int i;
+
+  for (i = 0; i < MAX_RENDER_SLICES; i++)
+    deferred_slices[i].count = 0;
+}
+
 void R_SetDefaultDrawColumnVars(draw_column_vars_t *dcvars) {
   dcvars->x = dcvars->yl = dcvars->yh = 0;
   dcvars->iscale = dcvars->texturemid = dcvars->texheight = 0;
@@ -452,6 +520,216 @@ void R_DrawSpan(draw_span_vars_t *dsvars) {
   }
 }
 
+//
+// Vector span drawers
+//
+// The texture coordinates of four pixels are stepped and masked together.
+// The flat and colormap lookups have no vector form and stay scalar, so the
+// output matches R_DrawSpan exactly. The last few pixels are left to it.
+//
+// Only spans have a vector version. A column steps a single texture
+// coordinate down the screen, and every pixel is two byte lookups and a
+// store a pitch apart. The quad flushes in r_drawflush.inl do handle four
+// adjacent columns per row, but a row is only four bytes:
+// - the opaque flush already moves it as one 32-bit word
+// - the translucent flush is four tranmap lookups, and the fuzz flush
+//   four reads at different fuzz offsets, with no SSE2 gather for either
+// AVX2 would only widen the coordinate stepping above. The lookups would
+// stay scalar.
+//
+
+#ifdef R_DRAWSPAN_SSE2
+static void R_DrawSpanSSE2(draw_span_vars_t *dsvars) {
+  unsigned count = dsvars->x2 - dsvars->x1 + 1;
+  unsigned xfrac = dsvars->xfrac;
+  unsigned yfrac = dsvars->yfrac;
+  const unsigned xstep = dsvars->xstep;
+  const unsigned ystep = dsvars->ystep;
+  const byte *source = dsvars->source;
+  const byte *colormap = dsvars->colormap;
+  byte *dest = drawvars.topleft + dsvars->y*drawvars.pitch + dsvars->x1;
+  const __m128i xmask = _mm_set1_epi32(63);
+  const __m128i ymask = _mm_set1_epi32(4032);
+  const __m128i xstep4 = _mm_set1_epi32(4 * xstep);
+  const __m128i ystep4 = _mm_set1_epi32(4 * ystep);
+  __m128i xv = _mm_setr_epi32(xfrac, xfrac + xstep, xfrac + 2 * xstep, xfrac + 3 * xstep);
+  __m128i yv = _mm_setr_epi32(yfrac, yfrac + ystep, yfrac + 2 * ystep, yfrac + 3 * ystep);
+  union { __m128i v; unsigned int i[4]; } spot;
+
+  while (count >= 4) {
+    spot.v = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(xv, 16), xmask),
+                          _mm_and_si128(_mm_srli_epi32(yv, 10), ymask));
+    xv = _mm_add_epi32(xv, xstep4);
+    yv = _mm_add_epi32(yv, ystep4);
+    dest[0] = colormap[source[spot.i[0]]];
+    dest[1] = colormap[source[spot.i[1]]];
+    dest[2] = colormap[source[spot.i[2]]];
+    dest[3] = colormap[source[spot.i[3]]];
+    dest += 4;
+    xfrac += 4 * xstep;
+    yfrac += 4 * ystep;
+    count -= 4;
+  }
+
+  while (count) {
+    const unsigned spot = ((xfrac >> 16) & 63) | ((yfrac >> 10) & 4032);
+    xfrac += xstep;
+    yfrac += ystep;
+    *dest++ = colormap[source[spot]];
+    count--;
+  }
+}
+#endif
+
+typedef struct {
+  const char *name;
+  R_DrawSpan_f func;
+  SDL_bool (SDLCALL *supported)(void);
+} span_drawer_t;
+
+// The last supported entry is used
+static const span_drawer_t span_drawers[] = {
+#ifdef R_DRAWSPAN_SSE2
+  { "SSE2", R_DrawSpanSSE2, SDL_HasSSE2 },
+#endif
+  { NULL }
+};
+
+static R_DrawSpan_f drawspanfunc = R_DrawSpan;
+
+R_DrawSpan_f R_GetDrawSpanFunc(void)
+{
+  return drawspanfunc;
+}
+
+//
+// -test_span_drawers draws the same random spans with R_DrawSpan and with
+// every vector drawer this cpu supports, and stops with an error unless
+// the screens match byte for byte, guard bytes included.
+//
+
+#define SPAN_TEST_WIDTH 1024
+#define SPAN_TEST_ROWS 8
+#define SPAN_TEST_COUNT 100000
+
+static unsigned int span_test_seed;
+
+// Not M_Random, so that the test never touches the game's random state
+static unsigned int R_SpanTestRandom(void)
+{
+  span_test_seed = span_test_seed * 1664525 + 1013904223;
+
+  return span_test_seed;
+}
+
+static unsigned long long R_DrawTestSpans(R_DrawSpan_f func, byte *screen,
+                                          const byte *source, const byte *colormap)
+{
+  draw_span_vars_t dsvars = { 0 };
+  unsigned long long elapsed;
+  int i;
+
+  memset(screen, 0xfb, SPAN_TEST_WIDTH * SPAN_TEST_ROWS);
+
+  dsvars.source = source;
+  dsvars.colormap = colormap;
+
+  span_test_seed = 1;
+  dsda_StartTimer(dsda_timer_temp);
+
+  for (i = 0; i < SPAN_TEST_COUNT; i++)
+  {
+    int length;
+
+    // Mostly short spans, to cover every tail length
+    length = (i & 1 ? R_SpanTestRandom() % 16 : R_SpanTestRandom() % (SPAN_TEST_WIDTH - 2)) + 1;
+
+    dsvars.y = 1 + R_SpanTestRandom() % (SPAN_TEST_ROWS - 2);
+    dsvars.x1 = 1 + R_SpanTestRandom() % (SPAN_TEST_WIDTH - 1 - length);
+    dsvars.x2 = dsvars.x1 + length - 1;
+    // Bounded so that R_DrawSpan's signed fracs can't overflow
+    dsvars.xfrac = (int) R_SpanTestRandom() >> 2;
+    dsvars.yfrac = (int) R_SpanTestRandom() >> 2;
+    dsvars.xstep = (int) R_SpanTestRandom() >> (12 + R_SpanTestRandom() % 8);
+    dsvars.ystep = (int) R_SpanTestRandom() >> (12 + R_SpanTestRandom() % 8);
+
+    func(&dsvars);
+  }
+
+  elapsed = dsda_ElapsedTime(dsda_timer_temp);
+
+  return elapsed;
+}
+
+static void R_TestSpanDrawers(void)
+{
+  draw_vars_t old_drawvars = drawvars;
+  unsigned long long scalar_time;
+  byte *expected, *actual, *source, *colormap;
+  const span_drawer_t *drawer;
+  int i;
+
+  expected = Z_Malloc(SPAN_TEST_WIDTH * SPAN_TEST_ROWS);
+  actual = Z_Malloc(SPAN_TEST_WIDTH * SPAN_TEST_ROWS);
+  source = Z_Malloc(64 * 64);
+  colormap = Z_Malloc(256);
+
+  span_test_seed = 2;
+  for (i = 0; i < 64 * 64; i++)
+    source[i] = R_SpanTestRandom() >> 24;
+  for (i = 0; i < 256; i++)
+    colormap[i] = R_SpanTestRandom() >> 24;
+
+  drawvars.pitch = SPAN_TEST_WIDTH;
+
+  drawvars.topleft = expected;
+  scalar_time = R_DrawTestSpans(R_DrawSpan, expected, source, colormap);
+
+  for (drawer = span_drawers; drawer->name; drawer++)
+  {
+    unsigned long long time;
+
+    if (!drawer->supported())
+    {
+      lprintf(LO_INFO, "R_TestSpanDrawers: %s not supported by this cpu\n", drawer->name);
+      continue;
+    }
+
+    drawvars.topleft = actual;
+    time = R_DrawTestSpans(drawer->func, actual, source, colormap);
+
+    if (memcmp(expected, actual, SPAN_TEST_WIDTH * SPAN_TEST_ROWS))
+      I_Error("R_TestSpanDrawers: %s span drawer differs from R_DrawSpan", drawer->name);
+
+    lprintf(LO_INFO, "R_TestSpanDrawers: %s matches R_DrawSpan on %d spans, "
+                     "%llu us against %llu us\n",
+            drawer->name, SPAN_TEST_COUNT, time, scalar_time);
+  }
+
+  drawvars = old_drawvars;
+
+  Z_Free(colormap);
+  Z_Free(source);
+  Z_Free(actual);
+  Z_Free(expected);
+}
+
+static void R_InitDrawSpanFunc(void)
+{
+  static dboolean tested;
+  const span_drawer_t *drawer;
+
+  if (!tested && dsda_Flag(dsda_arg_test_span_drawers))
+    R_TestSpanDrawers();
+  tested = true;
+
+  drawspanfunc = R_DrawSpan;
+
+  for (drawer = span_drawers; drawer->name; drawer++)
+    if (drawer->supported())
+      drawspanfunc = drawer->func;
+}
+
 void R_InitBuffersRes(void)
 {
   extern byte *solidcol;
@@ -480,6 +758,8 @@ void R_InitBuffer(int width, int height)
   drawvars.topleft = screens[0].data;
   drawvars.pitch = screens[0].pitch;
 
+  R_InitDrawSpanFunc();
+
   for (i=0; i<FUZZTABLE; i++)
     fuzzoffset[i] = fuzzoffset_org[i]*screens[0].pitch;
 }
@@ -119,9 +119,14 @@ extern byte       *translationtables;
 
 R_DrawColumn_f R_GetDrawColumnFunc(enum column_pipeline_e type, enum draw_filter_type_e filterz);
 
+typedef void (*R_DrawSpan_f)(draw_span_vars_t *dsvars);
+
 // Span blitting for rows, floor/ceiling. No Spectre effect needed.
 void R_DrawSpan(draw_span_vars_t *dsvars);
 
+// R_DrawSpan or a vector version of it, picked for this CPU
+R_DrawSpan_f R_GetDrawSpanFunc(void);
+
 void R_InitBuffer(int width, int height);
 
 void R_InitBuffersRes(void);
@@ -143,4 +148,10 @@ void R_ResetColumnBuffer(void);
 void R_SetFuzzPos(int fuzzpos);
 int R_GetFuzzPos();
 
+// Sliced rendering: draws the recorded wall columns of one slice
+R_DrawColumn_f R_GetUnbufferedColumnFunc(void);
+void R_DeferColumn(draw_column_vars_t *dcvars);
+void R_DrawDeferredColumns(int index);
+void R_ClearDeferredColumns(void);
+
 #endif
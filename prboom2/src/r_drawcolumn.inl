@@ -58,6 +58,11 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
   byte             *dest;            // killough
   fixed_t          frac;
   const fixed_t    fracstep = dcvars->iscale;
+#if (R_DRAWCOLUMN_PIPELINE & RDC_UNBUFFERED)
+  const int        deststep = drawvars.pitch;
+#else
+  const int        deststep = 4;
+#endif
 #endif
 
 #if (R_DRAWCOLUMN_PIPELINE & RDC_FUZZ)
@@ -101,6 +106,9 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
 #endif
 
   // Framebuffer destination address.
+#if (R_DRAWCOLUMN_PIPELINE & RDC_UNBUFFERED)
+  dest = drawvars.topleft + dcvars->yl*drawvars.pitch + dcvars->x;
+#else
    // SoM: MAGIC
    {
       // haleyjd: reordered predicates
@@ -139,6 +147,7 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
       }
       temp_x += 1;
    }
+#endif
 
 // do nothing else when drawin fuzz columns
 #if (!(R_DRAWCOLUMN_PIPELINE & RDC_FUZZ))
@@ -165,14 +174,14 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
       #define FIXEDT_128MASK ((127<<FRACBITS)|0xffff)
       while(count--) {
         *dest = GETCOL(frac & FIXEDT_128MASK);
-        dest += 4;
+        dest += deststep;
         frac += fracstep;
       }
     } else if (dcvars->texheight == 0) {
       /* cph - another special case */
       while (count--) {
         *dest = GETCOL(frac);
-        dest += 4;
+        dest += deststep;
         frac += fracstep;
       }
     } else {
@@ -181,10 +190,10 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
         fixed_t fixedt_heightmask = (heightmask<<FRACBITS)|0xffff;
         while ((count-=2)>=0) { // texture height is a power of 2 -- killough
           *dest = GETCOL(frac & fixedt_heightmask);
-          dest += 4;
+          dest += deststep;
           frac += fracstep;
           *dest = GETCOL(frac & fixedt_heightmask);
-          dest += 4;
+          dest += deststep;
           frac += fracstep;
         }
         if (count & 1)
@@ -206,7 +215,7 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
           // heightmask is the Tutti-Frutti fix -- killough
 
           *dest = GETCOL(frac);
-          dest += 4;
+          dest += deststep;
           if ((frac += fracstep) >= (int)heightmask)
             frac -= heightmask;
         }
@@ -60,7 +60,9 @@
 #include <math.h>
 #include "e6y.h"//e6y
 #include "xs_Float.h"
+#include "md5.h"
 
+#include "dsda/args.h"
 #include "dsda/configuration.h"
 #include "dsda/exhud.h"
 #include "dsda/map_format.h"
@@ -68,6 +70,8 @@
 #include "dsda/settings.h"
 #include "dsda/signal_context.h"
 #include "dsda/stretch.h"
+#include "dsda/thread_pool.h"
+#include "dsda/utility.h"
 #include "dsda/gl/render_scale.h"
 
 #include "hexen/a_action.h"
@@ -81,6 +85,9 @@ int LIGHTBRIGHT   = 2;
 
 int r_frame_count;
 
+// Vertical screen slices drawn in parallel (-render_threads)
+int render_slices = 1;
+
 // Fineangles in the SCREENWIDTH wide window.
 #define FIELDOFVIEW 2048
 
@@ -988,6 +995,104 @@ static void R_RenderBSPNodes(void)
   }
 }
 
+//
+// Sliced rendering
+//
+// The bsp walk stays on the main thread, recording wall columns instead
+// of drawing them. Walls and planes are then drawn in vertical slices on
+// worker threads, each slice in the original order, so the frame is the
+// same as a single threaded one. Masked drawing stays serial: fuzz
+// columns step one fuzz position across the whole frame, and the
+// translucent and fuzz paths share the column buffer.
+//
+
+static void R_SetRenderSlices(void)
+{
+  static int slices = -1;
+
+  if (slices < 0)
+  {
+    dsda_arg_t *arg = dsda_Arg(dsda_arg_render_threads);
+
+    slices = arg->found ? MIN(arg->value.v_int, MAX_RENDER_SLICES) : 1;
+  }
+
+  render_slices = V_IsSoftwareMode() && viewwidth >= slices ? slices : 1;
+}
+
+static void R_DrawSliceRange(int start, int end, void *data)
+{
+  int i;
+
+  for (i = start; i < end; i++)
+  {
+    int x1 = viewwidth * i / render_slices;
+    int x2 = viewwidth * (i + 1) / render_slices;
+
+    R_DrawDeferredColumns(i);
+    R_DrawPlaneSlice(i, x1, x2);
+  }
+}
+
+static void R_DrawSlices(void)
+{
+  R_PreparePlanes();
+
+  dsda_ParallelFor(render_slices, 1, R_DrawSliceRange, NULL);
+
+  R_ClearDeferredColumns();
+}
+
+//
+// Frame checksum
+//
+// -frame_checksum hashes every software frame as soon as the view is
+// drawn, and prints the result on exit. Two -timedemo runs of the same
+// demo with different -render_threads counts must print the same hash.
+//
+
+static int frame_checksum = -1;
+static int frame_checksum_frames;
+static struct MD5Context frame_checksum_md5;
+
+static void R_PrintFrameChecksum(void)
+{
+  dsda_cksum_t cksum;
+
+  if (!frame_checksum_frames)
+    return;
+
+  MD5Final(cksum.bytes, &frame_checksum_md5);
+  dsda_TranslateCheckSum(&cksum);
+
+  lprintf(LO_INFO, "Frame checksum: %d frames, %d slices, %s\n",
+          frame_checksum_frames, render_slices, cksum.string);
+}
+
+static void R_ChecksumFrame(void)
+{
+  int y;
+
+  if (frame_checksum < 0)
+  {
+    frame_checksum = dsda_Flag(dsda_arg_frame_checksum);
+
+    if (frame_checksum)
+    {
+      MD5Init(&frame_checksum_md5);
+      I_AtExit(R_PrintFrameChecksum, true, "R_PrintFrameChecksum", exit_priority_normal);
+    }
+  }
+
+  if (!frame_checksum)
+    return;
+
+  for (y = 0; y < screens[0].height; y++)
+    MD5Update(&frame_checksum_md5, screens[0].data + y * screens[0].pitch, screens[0].width);
+
+  frame_checksum_frames++;
+}
+
 //
 // R_RenderView
 //
@@ -996,6 +1101,8 @@ void R_RenderPlayerView (player_t* player)
 {
   r_frame_count++;
 
+  R_SetRenderSlices();
+
   DSDA_ADD_CONTEXT(sf_setup_frame);
   R_SetupFrame (player);
   DSDA_REMOVE_CONTEXT(sf_setup_frame);
@@ -1028,7 +1135,10 @@ void R_RenderPlayerView (player_t* player)
   if (V_IsSoftwareMode())
   {
     DSDA_ADD_CONTEXT(sf_draw_planes);
-    R_DrawPlanes();
+    if (render_slices > 1)
+      R_DrawSlices();
+    else
+      R_DrawPlanes();
     DSDA_REMOVE_CONTEXT(sf_draw_planes);
   }
 
@@ -1043,6 +1153,8 @@ void R_RenderPlayerView (player_t* player)
     R_DrawMasked ();
     R_ResetColumnBuffer();
     DSDA_REMOVE_CONTEXT(sf_draw_masked);
+
+    R_ChecksumFrame();
   }
 
   FakeNetUpdate();
@@ -38,6 +38,7 @@
 #include "r_data.h"
 
 extern int r_frame_count;
+extern int render_slices;
 
 //
 // POV related.
@@ -31,10 +31,9 @@
  *       while maintaining a per column clipping list only.
  *      Moreover, the sky areas have to be determined.
  *
- * MAXVISPLANES is no longer a limit on the number of visplanes,
- * but a limit on the number of hash slots; larger numbers mean
- * better performance usually but after a point they are wasted,
- * and memory and time overheads creep in.
+ * The visplane hash is sized from the number of visplanes in the
+ * previous frame, keeping chains short on detailed maps without
+ * wasting slots on simple ones.
  *
  * For more information on visplanes, see:
  *
@@ -70,18 +69,31 @@ fixed_t Sky1ColumnOffset;
 fixed_t Sky2ColumnOffset;
 dboolean DoubleSky;
 
-#define MAXVISPLANES 256    /* must be a power of 2 */
+#define MINVISPLANEHASH 256 /* must be a power of 2 */
+#define VISPLANEBLOCK 32    /* visplanes allocated at a time */
 
-static visplane_t *visplanes[MAXVISPLANES];   // killough
+static visplane_t **visplanes;                // killough
+static int numvisplanehash;                   // hash slots, a power of 2
+static int numvisplanes;                      // visplanes used this frame
 static visplane_t *freetail;                  // killough
 static visplane_t **freehead = &freetail;     // killough
 visplane_t *floorplane, *ceilingplane;
 
-// killough -- hash function for visplanes
-// Empirically verified to be fairly uniform:
+// Visplane storage, only released when the resolution changes
+static byte **visplaneblocks;
+static int numvisplaneblocks;
 
-#define visplane_hash(picnum,lightlevel,height) \
-  ((unsigned)((picnum)*3+(lightlevel)+(height)*7) & (MAXVISPLANES-1))
+// Mixes all the bits of the key into the slot number. Heights are
+// fixed point, so their low bits are usually zero.
+static unsigned visplane_hash(int picnum, int lightlevel, fixed_t height)
+{
+  unsigned hash = (unsigned) picnum * 0x9e3779b1u;
+
+  hash = (hash ^ (unsigned) lightlevel) * 0x85ebca6bu;
+  hash = (hash ^ (unsigned) height) * 0xc2b2ae35u;
+
+  return (hash ^ (hash >> 16)) & (numvisplanehash - 1);
+}
 
 size_t maxopenings;
 int *openings,*lastopening; // dropoff overflow
@@ -96,10 +108,19 @@ int *floorclip = NULL;
 int *ceilingclip = NULL;
 
 // spanstart holds the start of a plane span; initialized to 0 at start
+// Each render slice keeps its own SCREENHEIGHT entries
 
 // e6y: resolution limitation is removed
 static int *spanstart = NULL;                // killough 2/8/98
 
+// Screen columns x1 <= x < x2 drawn by one pass over the visplanes
+typedef struct
+{
+  int x1, x2;
+  int *spanstart;
+  R_DrawColumn_f colfunc;
+} plane_slice_t;
+
 //
 // texture mapping
 //
@@ -125,7 +146,7 @@ void R_InitPlanesRes(void)
 
   floorclip = Z_Calloc(1, SCREENWIDTH * sizeof(*floorclip));
   ceilingclip = Z_Calloc(1, SCREENWIDTH * sizeof(*ceilingclip));
-  spanstart = Z_Calloc(1, SCREENHEIGHT * sizeof(*spanstart));
+  spanstart = Z_Calloc(MAX_RENDER_SLICES, SCREENHEIGHT * sizeof(*spanstart));
 
   cachedheight = Z_Calloc(1, SCREENHEIGHT * sizeof(*cachedheight));
 
@@ -137,12 +158,42 @@ void R_InitVisplanesRes(void)
 {
   int i;
 
+  // The top and bottom arrays depend on the screen width
+  for (i = 0; i < numvisplaneblocks; i++)
+    Z_Free(visplaneblocks[i]);
+  numvisplaneblocks = 0;
+
   freetail = NULL;
   freehead = &freetail;
 
-  for (i = 0; i < MAXVISPLANES; i++)
+  if (!visplanes)
   {
-    visplanes[i] = 0;
+    numvisplanehash = MINVISPLANEHASH;
+    visplanes = Z_Calloc(numvisplanehash, sizeof(*visplanes));
+  }
+  else
+  {
+    memset(visplanes, 0, numvisplanehash * sizeof(*visplanes));
+  }
+}
+
+// Aims for about one visplane per slot, shrinking only once the table
+// is eight times larger than needed, so that it doesn't flip every frame
+static void R_ResizeVisplaneHash(void)
+{
+  int size = numvisplanehash;
+
+  while (size < numvisplanes)
+    size <<= 1;
+
+  while (size > MINVISPLANEHASH && size / 8 >= numvisplanes)
+    size >>= 1;
+
+  if (size != numvisplanehash)
+  {
+    Z_Free(visplanes);
+    visplanes = Z_Calloc(size, sizeof(*visplanes));
+    numvisplanehash = size;
   }
 }
 
@@ -158,7 +209,8 @@ void R_InitPlanes (void)
 // R_MapPlane
 //
 
-static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars)
+static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars,
+                       const plane_slice_t *slice)
 {
   int64_t den;
   fixed_t distance;
@@ -180,6 +232,10 @@ static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars)
   // See cchest2.wad/map02/room with sector #265
   if (centery == y)
     return;
+
+  if (x2 < slice->x1 || x1 >= slice->x2)
+    return;
+
   den = (int64_t)FRACUNIT * FRACUNIT * D_abs(centery - y);
   distance = FixedMul(dsvars->planeheight, yslope[y]);
 
@@ -196,6 +252,17 @@ static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars)
   dsvars->xfrac = FixedMul(dsvars->xfrac, dsvars->xscale);
   dsvars->yfrac = FixedMul(dsvars->yfrac, dsvars->yscale);
 
+  // Step to the slice edge the same way R_DrawSpan would have
+  if (x1 < slice->x1)
+  {
+    dsvars->xfrac = (fixed_t)((unsigned)dsvars->xfrac + (unsigned)(slice->x1 - x1) * dsvars->xstep);
+    dsvars->yfrac = (fixed_t)((unsigned)dsvars->yfrac + (unsigned)(slice->x1 - x1) * dsvars->ystep);
+    x1 = slice->x1;
+  }
+
+  if (x2 >= slice->x2)
+    x2 = slice->x2 - 1;
+
   if (!(dsvars->colormap = fixedcolormap))
   {
     dsvars->z = distance;
@@ -214,7 +281,7 @@ static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars)
   dsvars->x2 = x2;
 
   if (V_IsSoftwareMode())
-    R_DrawSpan(dsvars);
+    R_GetDrawSpanFunc()(dsvars);
 }
 
 //
@@ -230,10 +297,13 @@ void R_ClearPlanes(void)
   for (i=0 ; i<viewwidth ; i++)
     floorclip[i] = viewheight, ceilingclip[i] = -1;
 
-  for (i=0;i<MAXVISPLANES;i++)    // new code -- killough
+  for (i=0;i<numvisplanehash;i++)    // new code -- killough
     for (*freehead = visplanes[i], visplanes[i] = NULL; *freehead; )
       freehead = &(*freehead)->next;
 
+  R_ResizeVisplaneHash();
+  numvisplanes = 0;
+
   lastopening = openings;
 
   // texture calculation
@@ -242,18 +312,43 @@ void R_ClearPlanes(void)
 
 // New function, by Lee Killough
 
-static visplane_t *new_visplane(unsigned hash)
+// Adds VISPLANEBLOCK visplanes to the free list
+static void R_AllocVisplaneBlock(void)
 {
-  visplane_t *check = freetail;
-  if (!check)
+  visplane_t *pl;
+  byte *block;
+  size_t size;
+  int i;
+
+  // e6y: resolution limitation is removed
+  size = sizeof(*pl) + sizeof(*pl->top) * (SCREENWIDTH * 2);
+  size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+  block = Z_Calloc(VISPLANEBLOCK, size);
+
+  visplaneblocks = Z_Realloc(visplaneblocks, (numvisplaneblocks + 1) * sizeof(*visplaneblocks));
+  visplaneblocks[numvisplaneblocks++] = block;
+
+  for (i = 0; i < VISPLANEBLOCK; i++)
   {
-    // e6y: resolution limitation is removed
-    check = Z_Calloc(1, sizeof(*check) + sizeof(*check->top) * (SCREENWIDTH * 2));
-    check->bottom = &check->top[SCREENWIDTH + 2];
+    pl = (visplane_t *) (block + i * size);
+    pl->bottom = &pl->top[SCREENWIDTH + 2];
+    *freehead = pl;
+    freehead = &pl->next;
   }
-  else
-    if (!(freetail = freetail->next))
-      freehead = &freetail;
+}
+
+static visplane_t *new_visplane(unsigned hash)
+{
+  visplane_t *check;
+
+  if (!freetail)
+    R_AllocVisplaneBlock();
+
+  check = freetail;
+  if (!(freetail = freetail->next))
+    freehead = &freetail;
+  ++numvisplanes;
   check->next = visplanes[hash];
   visplanes[hash] = check;
   return check;
@@ -377,12 +472,14 @@ visplane_t *R_CheckPlane(visplane_t *pl, int start, int stop)
 
 static void R_MakeSpans(int x, unsigned int t1, unsigned int b1,
                         unsigned int t2, unsigned int b2,
-                        draw_span_vars_t *dsvars)
+                        draw_span_vars_t *dsvars, const plane_slice_t *slice)
 {
+  int *spanstart = slice->spanstart;
+
   for (; t1 < t2 && t1 <= b1; t1++)
-    R_MapPlane(t1, spanstart[t1], x-1, dsvars);
+    R_MapPlane(t1, spanstart[t1], x-1, dsvars, slice);
   for (; b1 > b2 && b1 >= t1; b1--)
-    R_MapPlane(b1, spanstart[b1] ,x-1, dsvars);
+    R_MapPlane(b1, spanstart[b1] ,x-1, dsvars, slice);
   while (t2 < t1 && t2 <= b2)
     spanstart[t2++] = x;
   while (b2 > b1 && b2 >= t2)
@@ -411,15 +508,18 @@ const rpatch_t *R_HackedSkyPatch(texture_t *texture)
 
 // New function, by Lee Killough
 
-static void R_DoDrawPlane(visplane_t *pl)
+static void R_DoDrawPlane(visplane_t *pl, const plane_slice_t *slice)
 {
   register int x;
   draw_column_vars_t dcvars;
-  R_DrawColumn_f colfunc = R_GetDrawColumnFunc(RDC_PIPELINE_STANDARD, RDRAW_FILTER_POINT);
+  R_DrawColumn_f colfunc = slice->colfunc;
+  int minx = MAX(pl->minx, slice->x1);
+  int maxx = MIN(pl->maxx, slice->x2 - 1);
 
   R_SetDefaultDrawColumnVars(&dcvars);
 
-  if (pl->minx <= pl->maxx) {
+  // Planes outside the slice are left to the other slices
+  if (minx <= maxx) {
     // hexen_note: Skies
     // if (pl->picnum == skyflatnum)
     // {                       // Sky flat
@@ -598,7 +698,7 @@ static void R_DoDrawPlane(visplane_t *pl)
           dcvars.texturemid = 200 << FRACBITS;
           dcvars.iscale = (200 << FRACBITS) / SCREENHEIGHT;
 
-          for (x = pl->minx; (dcvars.x = x) <= pl->maxx; x++)
+          for (x = minx; (dcvars.x = x) <= maxx; x++)
             if ((dcvars.yl = pl->top[x]) != SHRT_MAX && dcvars.yl <= (dcvars.yh = pl->bottom[x])) // dropoff overflow
             {
               dcvars.source = R_GetPatchColumn(patch, (an + xtoviewangle[x]) >> ANGLETOSKYSHIFT)->pixels;
@@ -614,7 +714,7 @@ static void R_DoDrawPlane(visplane_t *pl)
       tex_patch = R_TextureCompositePatchByNum(texture);
 
       // killough 10/98: Use sky scrolling offset, and possibly flip picture
-      for (x = pl->minx; (dcvars.x = x) <= pl->maxx; x++)
+      for (x = minx; (dcvars.x = x) <= maxx; x++)
         if ((dcvars.yl = pl->top[x]) != SHRT_MAX && dcvars.yl <= (dcvars.yh = pl->bottom[x])) // dropoff overflow
         {
           dcvars.source = R_GetTextureColumn(tex_patch, ((an + xtoviewangle[x])^flip) >> ANGLETOSKYSHIFT);
@@ -749,13 +849,19 @@ static void R_DoDrawPlane(visplane_t *pl)
       if(light < 0)
         light = 0;
 
-      stop = pl->maxx + 1;
+      // Spans are found from the left edge of the plane, so that each one
+      // keeps its true start; R_MapPlane clips them to the slice. Columns
+      // past the slice aren't walked, the spans still open there are closed
+      // at its edge instead, as the dropoff overflow does at maxx + 1.
+      stop = MIN(pl->maxx + 1, slice->x2);
       dsvars.planezlight = zlight[light];
-      pl->top[pl->minx-1] = pl->top[stop] = SHRT_MAX; // dropoff overflow
 
-      for (x = pl->minx ; x <= stop ; x++)
+      for (x = pl->minx ; x < stop ; x++)
          R_MakeSpans(x,pl->top[x-1],pl->bottom[x-1],
-                     pl->top[x],pl->bottom[x], &dsvars);
+                     pl->top[x],pl->bottom[x], &dsvars, slice);
+
+      R_MakeSpans(stop,pl->top[stop-1],pl->bottom[stop-1],
+                  SHRT_MAX,0, &dsvars, slice);
     }
   }
 }
@@ -765,15 +871,88 @@ static void R_DoDrawPlane(visplane_t *pl)
 // At the end of each frame.
 //
 
+// Lookups that may load data, and writes to the plane itself, are done
+// here before any drawing so that slices can be drawn concurrently
+static void R_PreparePlane(visplane_t *pl)
+{
+  dsda_RecordVisPlane();
+
+  if (pl->minx > pl->maxx)
+    return;
+
+  if (pl->picnum == skyflatnum || pl->picnum & PL_SKYFLAT)
+  {
+    int texture;
+
+    if (pl->picnum & PL_SKYFLAT)
+    {
+      const line_t *l = &lines[pl->picnum & ~PL_SKYFLAT];
+      const side_t *s = *l->sidenum + sides;
+
+      texture = texturetranslation[s->toptexture];
+    }
+    else
+      texture = skytexture;
+
+    R_HackedSkyPatch(textures[texture]);
+    R_TextureCompositePatchByNum(texture);
+  }
+  else
+  {
+    W_LumpByNum(firstflat + flattranslation[pl->picnum]);
+
+    pl->top[pl->minx-1] = pl->top[pl->maxx+1] = SHRT_MAX; // dropoff overflow
+  }
+}
+
 void R_DrawPlanes (void)
 {
   visplane_t *pl;
   int i;
-  for (i=0;i<MAXVISPLANES;i++)
+  plane_slice_t slice;
+
+  slice.x1 = 0;
+  slice.x2 = viewwidth;
+  slice.spanstart = spanstart;
+  slice.colfunc = R_GetDrawColumnFunc(RDC_PIPELINE_STANDARD, RDRAW_FILTER_POINT);
+
+  for (i=0;i<numvisplanehash;i++)
     for (pl=visplanes[i]; pl; pl=pl->next)
     {
-      dsda_RecordVisPlane();
-
-      R_DoDrawPlane(pl);
+      R_PreparePlane(pl);
+      R_DoDrawPlane(pl, &slice);
     }
 }
+
+//
+// R_PreparePlanes / R_DrawPlaneSlice
+// Sliced rendering: planes are prepared once on the main thread, then
+// each slice draws the visplanes clipped to its columns, in the same
+// order as R_DrawPlanes.
+//
+
+void R_PreparePlanes(void)
+{
+  visplane_t *pl;
+  int i;
+
+  for (i=0;i<numvisplanehash;i++)
+    for (pl=visplanes[i]; pl; pl=pl->next)
+      R_PreparePlane(pl);
+}
+
+void R_DrawPlaneSlice(int index, int x1, int x2)
+{
+  visplane_t *pl;
+  int i;
+  plane_slice_t slice;
+
+  slice.x1 = x1;
+  slice.x2 = x2;
+  slice.spanstart = spanstart + index * SCREENHEIGHT;
+  slice.colfunc = R_GetUnbufferedColumnFunc();
+
+  for (i=0;i<numvisplanehash;i++)
+    for (pl=visplanes[i]; pl; pl=pl->next)
+      R_DoDrawPlane(pl, &slice);
+}
@@ -52,6 +52,12 @@ void R_InitPlanes(void);
 void R_ClearPlanes(void);
 void R_DrawPlanes (void);
 
+// Sliced rendering
+#define MAX_RENDER_SLICES 16
+
+void R_PreparePlanes(void);
+void R_DrawPlaneSlice(int index, int x1, int x2);
+
 const rpatch_t *R_HackedSkyPatch(texture_t *texture);
 
 visplane_t *R_FindPlane(
@@ -480,7 +480,8 @@ static int didsolidcol; /* True if at least one column was marked solid */
 static void R_RenderSegLoop (void)
 {
   const rpatch_t *tex_patch;
-  R_DrawColumn_f colfunc = R_GetDrawColumnFunc(RDC_PIPELINE_STANDARD, RDRAW_FILTER_POINT);
+  R_DrawColumn_f colfunc = render_slices > 1 ? R_DeferColumn :
+                           R_GetDrawColumnFunc(RDC_PIPELINE_STANDARD, RDRAW_FILTER_POINT);
   draw_column_vars_t dcvars;
   fixed_t texturecolumn = 0;
   fixed_t specific_texturecolumn = 0;
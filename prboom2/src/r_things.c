@@ -83,13 +83,18 @@ typedef struct drawsegs_xrange_s
 {
   drawseg_xrange_item_t *items;
   int count;
+  int size;
 } drawsegs_xrange_t;
 
-#define DS_RANGES_COUNT 3
+// The view is split in half DS_RANGES_DEPTH - 1 times. Each range lists the
+// drawsegs overlapping it, and a sprite only checks the smallest range
+// that holds it. Ranges are stored level by level, the whole view first.
+#define DS_RANGES_DEPTH 5
+#define DS_RANGES_COUNT ((1 << DS_RANGES_DEPTH) - 1)
 static drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
+static int drawsegs_xrange_shift;
 
 static drawseg_xrange_item_t *drawsegs_xrange;
-static unsigned int drawsegs_xrange_size = 0;
 static int drawsegs_xrange_count = 0;
 
 // constant arrays
@@ -1350,6 +1355,86 @@ static void msort(vissprite_t **s, vissprite_t **t, int n)
     }
 }
 
+//
+// Radix sort for frames with many vissprites, where msort's comparisons
+// miss the cache. It produces exactly the order msort would: when merging
+// equal scales msort takes the right half first, so equal scales end up
+// with its insertion sort runs in reverse, each run in its original order.
+// Laying the runs out that way makes a stable sort on scale match it.
+//
+
+#define RADIX_SORT_MIN 1024
+
+static unsigned int *vissprite_keys;
+
+static vissprite_t **R_ReverseSortRuns(vissprite_t **s, int n, vissprite_t **d)
+{
+  if (n >= 16)
+    {
+      int n1 = n/2;
+
+      d = R_ReverseSortRuns(s + n1, n - n1, d);
+      return R_ReverseSortRuns(s, n1, d);
+    }
+
+  bcopyp(d, s, n);
+  return d + n;
+}
+
+static void R_RadixSortVisSprites(vissprite_t **s, int n)
+{
+  unsigned int count[4][256];
+  vissprite_t **src = s + n, **dst = s, **swap;
+  unsigned int *ksrc = vissprite_keys, *kdst = vissprite_keys + n, *kswap;
+  int i, pass;
+
+  R_ReverseSortRuns(s, n, src);
+
+  // Descending scale is ascending key
+  memset(count, 0, sizeof(count));
+  for (i = 0; i < n; i++)
+    {
+      unsigned int key = ~((unsigned int) src[i]->scale ^ 0x80000000u);
+
+      ksrc[i] = key;
+      count[0][key & 255]++;
+      count[1][(key >> 8) & 255]++;
+      count[2][(key >> 16) & 255]++;
+      count[3][key >> 24]++;
+    }
+
+  for (pass = 0; pass < 4; pass++)
+    {
+      unsigned int *c = count[pass];
+      unsigned int sum = 0;
+      int shift = pass * 8;
+
+      // every key has the same digit here
+      if (c[(ksrc[0] >> shift) & 255] == (unsigned int) n)
+        continue;
+
+      for (i = 0; i < 256; i++)
+        {
+          unsigned int t = c[i];
+          c[i] = sum;
+          sum += t;
+        }
+
+      for (i = 0; i < n; i++)
+        {
+          unsigned int d = c[(ksrc[i] >> shift) & 255]++;
+          dst[d] = src[i];
+          kdst[d] = ksrc[i];
+        }
+
+      swap = src, src = dst, dst = swap;
+      kswap = ksrc, ksrc = kdst, kdst = kswap;
+    }
+
+  if (src != s)
+    bcopyp(s, src, n);
+}
+
 void R_SortVisSprites (void)
 {
   if (num_vissprite)
@@ -1365,6 +1450,8 @@ void R_SortVisSprites (void)
           Z_Free(vissprite_ptrs);  // better than realloc -- no preserving needed
           vissprite_ptrs = Z_Malloc((num_vissprite_ptrs = num_vissprite_alloc*2)
                                   * sizeof *vissprite_ptrs);
+          Z_Free(vissprite_keys);
+          vissprite_keys = Z_Malloc(num_vissprite_ptrs * sizeof *vissprite_keys);
         }
 
       while (--i>=0)
@@ -1373,7 +1460,10 @@ void R_SortVisSprites (void)
       // killough 9/22/98: replace qsort with merge sort, since the keys
       // are roughly in order to begin with, due to BSP rendering.
 
-      msort(vissprite_ptrs, vissprite_ptrs + num_vissprite, num_vissprite);
+      if (num_vissprite >= RADIX_SORT_MIN)
+        R_RadixSortVisSprites(vissprite_ptrs, num_vissprite);
+      else
+        msort(vissprite_ptrs, vissprite_ptrs + num_vissprite, num_vissprite);
     }
 }
 
@@ -1403,7 +1493,7 @@ static void R_DrawSprite (vissprite_t* spr)
   // and buggy, by going past LEFT end of array):
 
   // e6y: optimization
-  if (drawsegs_xrange_size)
+  if (drawsegs_xrange_count)
   {
     const drawseg_xrange_item_t *last = &drawsegs_xrange[drawsegs_xrange_count - 1];
     drawseg_xrange_item_t *curr = &drawsegs_xrange[-1];
@@ -1519,60 +1609,86 @@ static void R_DrawSprite (vissprite_t* spr)
 // R_DrawMasked
 //
 
-void R_DrawMasked(void)
+static void R_AddDrawSegXRange(drawsegs_xrange_t *range, const drawseg_xrange_item_t *item)
 {
-  int i;
-  drawseg_t *ds;
-  int cx = SCREENWIDTH / 2;
+  if (range->count == range->size)
+  {
+    range->size = range->size ? 2 * range->size : 128;
+    range->items = Z_Realloc(range->items, range->size * sizeof(range->items[0]));
+  }
 
-  R_SortVisSprites();
+  range->items[range->count++] = *item;
+}
+
+// e6y
+// Reducing of cache misses in the following R_DrawSprite()
+// Makes sense for scenes with huge amount of drawsegs.
+// ~12% of speed improvement on epic.wad map05
+// e6y: ~13% of speed improvement on sunder.wad map10
+static void R_BuildDrawSegXRanges(void)
+{
+  drawseg_t *ds;
+  int i;
 
-  // e6y
-  // Reducing of cache misses in the following R_DrawSprite()
-  // Makes sense for scenes with huge amount of drawsegs.
-  // ~12% of speed improvement on epic.wad map05
   for(i = 0; i < DS_RANGES_COUNT; i++)
     drawsegs_xranges[i].count = 0;
 
-  if (num_vissprite > 0)
+  // Ranges at the deepest level are 1 << drawsegs_xrange_shift columns
+  drawsegs_xrange_shift = 0;
+  while ((viewwidth - 1) >> drawsegs_xrange_shift >= (1 << (DS_RANGES_DEPTH - 1)))
+    drawsegs_xrange_shift++;
+
+  // Kept in the order R_DrawSprite checks them, nearest first
+  for (ds = ds_p; ds-- > drawsegs;)
   {
-    if (drawsegs_xrange_size < maxdrawsegs)
+    if (ds->silhouette || ds->maskedtexturecol)
     {
-      drawsegs_xrange_size = 2 * maxdrawsegs;
-      for(i = 0; i < DS_RANGES_COUNT; i++)
+      drawseg_xrange_item_t item;
+      int level;
+
+      item.x1 = ds->x1;
+      item.x2 = ds->x2;
+      item.user = ds;
+
+      for (level = 0; level < DS_RANGES_DEPTH; level++)
       {
-        drawsegs_xranges[i].items = Z_Realloc(
-          drawsegs_xranges[i].items,
-          drawsegs_xrange_size * sizeof(drawsegs_xranges[i].items[0]));
+        int shift = drawsegs_xrange_shift + DS_RANGES_DEPTH - 1 - level;
+        int first = (1 << level) - 1;
+        int k;
+
+        for (k = ds->x1 >> shift; k <= ds->x2 >> shift; k++)
+          R_AddDrawSegXRange(&drawsegs_xranges[first + k], &item);
       }
     }
-    for (ds = ds_p; ds-- > drawsegs;)
-    {
-      if (ds->silhouette || ds->maskedtexturecol)
-      {
-        drawsegs_xranges[0].items[drawsegs_xranges[0].count].x1 = ds->x1;
-        drawsegs_xranges[0].items[drawsegs_xranges[0].count].x2 = ds->x2;
-        drawsegs_xranges[0].items[drawsegs_xranges[0].count].user = ds;
+  }
+}
 
-        // e6y: ~13% of speed improvement on sunder.wad map10
-        if (ds->x1 < cx)
-        {
-          drawsegs_xranges[1].items[drawsegs_xranges[1].count] =
-            drawsegs_xranges[0].items[drawsegs_xranges[0].count];
-          drawsegs_xranges[1].count++;
-        }
-        if (ds->x2 >= cx)
-        {
-          drawsegs_xranges[2].items[drawsegs_xranges[2].count] =
-            drawsegs_xranges[0].items[drawsegs_xranges[0].count];
-          drawsegs_xranges[2].count++;
-        }
+// The smallest range holding all of the sprite's columns
+static const drawsegs_xrange_t *R_DrawSegXRange(const vissprite_t *spr)
+{
+  int level;
 
-        drawsegs_xranges[0].count++;
-      }
-    }
+  for (level = DS_RANGES_DEPTH - 1; level > 0; level--)
+  {
+    int shift = drawsegs_xrange_shift + DS_RANGES_DEPTH - 1 - level;
+
+    if (spr->x1 >> shift == spr->x2 >> shift)
+      return &drawsegs_xranges[(1 << level) - 1 + (spr->x1 >> shift)];
   }
 
+  return &drawsegs_xranges[0];
+}
+
+void R_DrawMasked(void)
+{
+  int i;
+  drawseg_t *ds;
+
+  R_SortVisSprites();
+
+  if (num_vissprite > 0)
+    R_BuildDrawSegXRanges();
+
   // draw all vissprites back to front
 
   dsda_RecordVisSprites(num_vissprite);
@@ -1580,22 +1696,11 @@ void R_DrawMasked(void)
   for (i = num_vissprite ;--i>=0; )
   {
     vissprite_t* spr = vissprite_ptrs[i];
+    const drawsegs_xrange_t *range = R_DrawSegXRange(spr);
 
-    if (spr->x2 < cx)
-    {
-      drawsegs_xrange = drawsegs_xranges[1].items;
-      drawsegs_xrange_count = drawsegs_xranges[1].count;
-    }
-    else if (spr->x1 >= cx)
-    {
-      drawsegs_xrange = drawsegs_xranges[2].items;
-      drawsegs_xrange_count = drawsegs_xranges[2].count;
-    }
-    else
-    {
-      drawsegs_xrange = drawsegs_xranges[0].items;
-      drawsegs_xrange_count = drawsegs_xranges[0].count;
-    }
+    drawsegs_xrange = range->items;
+    drawsegs_xrange_count = range->count;
+    dsda_RecordSpriteClips(drawsegs_xrange_count);
 
     R_DrawSprite(vissprite_ptrs[i]);
   }
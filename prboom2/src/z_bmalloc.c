@@ -42,6 +42,8 @@
 #include "z_bmalloc.h"
 #include "lprintf.h"
 
+#include "dsda/args.h"
+
 typedef struct bmalpool_s {
   struct bmalpool_s *nextpool;
   size_t             blocks;
@@ -123,3 +125,117 @@ void Z_BFree(struct block_memory_alloc_s *pzone, void* p)
   }
   I_Error("Z_BFree: Free not in zone %s", pzone->desc);
 }
+
+//
+// Size-class pool
+//
+// Level lifetime objects like mobjs and thinkers come from per-size free
+// lists carved out of large level allocations. Each element has a short
+// header whose signature sits where a zone block keeps its own, so Z_Free
+// takes either kind of pointer. Z_FreeLevel drops the lists wholesale.
+// -no_level_pool sends every request straight to the zone instead.
+//
+
+#define POOL_SIGNATURE 0x7a3c61e5
+#define POOL_FREE_SIGNATURE 0x7a3c61e6
+#define POOL_GRANULARITY 16
+#define POOL_CLASSES 64
+#define POOL_CHUNK_BYTES 0x10000
+
+typedef struct {
+  unsigned size_class;
+  unsigned signature;
+} pool_header_t;
+
+typedef struct pool_free_s {
+  struct pool_free_s *next;
+} pool_free_t;
+
+static pool_free_t *pool_free_list[POOL_CLASSES];
+static int pool_enabled = -1;
+
+int Z_PoolEnabled(void)
+{
+  if (pool_enabled < 0)
+    pool_enabled = !dsda_Flag(dsda_arg_no_level_pool);
+
+  return pool_enabled;
+}
+
+static void Z_PoolGrow(int size_class)
+{
+  size_t stride, count, i;
+  byte *chunk;
+
+  stride = sizeof(pool_header_t) + (size_class + 1) * POOL_GRANULARITY;
+  count = POOL_CHUNK_BYTES / stride;
+  if (count < 16)
+    count = 16;
+
+  chunk = Z_MallocLevel(stride * count);
+
+  // Hand out the lowest addresses first
+  for (i = count; i-- > 0; ) {
+    pool_header_t *header = (pool_header_t *)(chunk + stride * i);
+    pool_free_t *element = (pool_free_t *)(header + 1);
+
+    header->size_class = size_class;
+    header->signature = POOL_FREE_SIGNATURE;
+    element->next = pool_free_list[size_class];
+    pool_free_list[size_class] = element;
+  }
+}
+
+void *Z_PoolMalloc(size_t size)
+{
+  pool_free_t *element;
+  int size_class;
+
+  if (!size)
+    return NULL;
+
+  if (size > POOL_CLASSES * POOL_GRANULARITY || !Z_PoolEnabled())
+    return Z_MallocLevel(size);
+
+  size_class = (size - 1) / POOL_GRANULARITY;
+
+  if (!pool_free_list[size_class])
+    Z_PoolGrow(size_class);
+
+  element = pool_free_list[size_class];
+  pool_free_list[size_class] = element->next;
+  ((pool_header_t *) element - 1)->signature = POOL_SIGNATURE;
+
+  return element;
+}
+
+int Z_PoolOwns(const void *p)
+{
+  unsigned signature = ((const pool_header_t *) p - 1)->signature;
+
+  return signature == POOL_SIGNATURE || signature == POOL_FREE_SIGNATURE;
+}
+
+size_t Z_PoolSize(const void *p)
+{
+  return (((const pool_header_t *) p - 1)->size_class + 1) * POOL_GRANULARITY;
+}
+
+void Z_PoolFree(void *p)
+{
+  pool_free_t *element = p;
+  pool_header_t *header = (pool_header_t *) p - 1;
+  int size_class = header->size_class;
+
+  if (header->signature == POOL_FREE_SIGNATURE)
+    I_Error("Z_PoolFree: double free");
+  header->signature = POOL_FREE_SIGNATURE;
+
+  element->next = pool_free_list[size_class];
+  pool_free_list[size_class] = element;
+}
+
+void Z_PoolFreeLevel(void)
+{
+  memset(pool_free_list, 0, sizeof(pool_free_list));
+}
@@ -53,4 +53,10 @@ inline static void* Z_BCalloc(struct block_memory_alloc_s *pzone)
 
 void Z_BFree(struct block_memory_alloc_s *pzone, void* p);
 
+int Z_PoolEnabled(void);
+int Z_PoolOwns(const void *p);
+size_t Z_PoolSize(const void *p);
+void Z_PoolFree(void *p);
+void Z_PoolFreeLevel(void);
+
 #endif //__Z_BMALLOC__
@@ -54,6 +54,7 @@
 #include "v_video.h"
 #include "g_game.h"
 #include "lprintf.h"
+#include "z_bmalloc.h"
 
 #ifdef DJGPP
 #include <dpmi.h>
@@ -67,11 +68,13 @@ enum {
   ZONE_MAX
 };
 
+// The signature must stay last, directly before the block data,
+// where Z_Free also looks for the size-class pool signature
 typedef struct memblock {
-  unsigned signature;
   struct memblock *next,*prev;
   size_t size;
   unsigned char tag;
+  unsigned signature;
 } memblock_t;
 
 static const size_t HEADER_SIZE = sizeof(memblock_t);
@@ -128,6 +131,12 @@ void Z_Free(void *p)
   if (!p)
     return;
 
+  if (Z_PoolOwns(p))
+  {
+    Z_PoolFree(p);
+    return;
+  }
+
   if (block->signature != ZONE_SIGNATURE)
     I_Error("Z_Free: freed a non-zone pointer");
   block->signature = 0;       // Nullify signature so another free fails
@@ -170,7 +179,8 @@ static void *Z_ReallocTag(void *ptr, size_t n, int tag)
   if (ptr)
     {
       memblock_t *block = (memblock_t *)((char *) ptr - HEADER_SIZE);
-      memcpy(p, ptr, n <= block->size ? n : block->size);
+      size_t size = Z_PoolOwns(ptr) ? Z_PoolSize(ptr) : block->size;
+      memcpy(p, ptr, n <= size ? n : size);
       Z_Free(ptr);
     }
   return p;
@@ -209,7 +219,8 @@ char *Z_Strdup(const char *s)
 
 void Z_FreeLevel(void)
 {
-  return Z_FreeTag(ZONE_LEVEL);
+  Z_PoolFreeLevel();
+  Z_FreeTag(ZONE_LEVEL);
 }
 
 void *Z_MallocLevel(size_t size)
@@ -62,4 +62,6 @@ void *Z_CallocLevel(size_t n, size_t n2);
 void *Z_ReallocLevel(void *p, size_t n);
 char *Z_StrdupLevel(const char *s);
 
+void *Z_PoolMalloc(size_t size);
+
 #endif
@@ -0,0 +1,31 @@
+RSpec.describe 'brute force' do
+  let(:pwad) { nil }
+  let(:condition) { nil }
+
+  subject do
+    Utility.brute_force(
+      commands: "bf.engine #{engine}; bf.start #{condition}",
+      pwad: pwad,
+      extra: '-skill 4 -warp 1'
+    )
+  end
+
+  # The only route crosses a teleport line 64 units ahead, which sends
+  #   the player far outside the reach of their own movement
+  context 'through a teleport' do
+    let(:pwad) { 'bf_teleport.wad' }
+    let(:condition) { '14 49:50 0:0 0:0 x > 2000' }
+
+    context 'depth first' do
+      let(:engine) { 'dfs' }
+
+      it { is_expected.to include('Brute force complete (SUCCESS)') }
+    end
+
+    context 'beam' do
+      let(:engine) { 'beam' }
+
+      it { is_expected.to include('Brute force complete (SUCCESS)') }
+    end
+  end
+end
@@ -11,6 +11,16 @@ module Utility
     system(command)
   end
 
+  def brute_force(commands:, pwad:, iwad: "DOOM2.WAD", extra: nil)
+    command = "./build/dsda-doom.exe -iwad spec/support/wads/#{iwad}"
+    command << " -file spec/support/wads/#{pwad}"
+    command << " -nosound -nomusic -nodraw -build -quit_after_brute_force"
+    command << " #{extra}" if extra
+    command << " -command \"#{commands}\""
+
+    `#{command} 2>&1`
+  end
+
   def read_analysis
     Analysis.new
   end